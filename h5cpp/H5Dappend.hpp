@@ -10,9 +10,107 @@
 
 namespace h5 {
 	struct pt_t;
+	struct pt_manager_t;
 }
 std::ostream& operator<<(std::ostream& os, const h5::pt_t& pt);
 
+namespace h5 { namespace impl {
+	/* background flushing of packet table, requested with h5::async_write{depth} on the dapl: full chunks are
+	 * handed over to an IO thread, which extends the dataset and pushes them through the pipeline -- filters
+	 * included -- in submission order, while the producer keeps appending into the next free buffer of a pool
+	 * of depth + 1; once all `depth` chunks are in flight the producer blocks until one of them is written.
+	 * The IO thread calls HDF5 while the producer runs, hence it is started only when H5CPP_HAVE_THREADSAFE_IO is
+	 * defined, otherwise chunks are written synchronously; HDF5 calls of the producer on the same dataset, as of
+	 * h5::key_index, are made after `drain`
+	 */
+	struct pt_writer_t {
+		pt_writer_t() : submitted(0), written(0), done(false) {}
+		~pt_writer_t(){ stop(); }
+		// allocates pool of buffers and starts IO thread, `dims` is the current extent of `ds`
+		void start( impl::basic_pipeline_t* pipeline, ::hid_t ds, unsigned depth, hsize_t rank, const hsize_t* dims );
+		// next free buffer of the pool, blocks while all of them are in flight
+		char* acquire();
+		// queues content of `ptr` obtained with `acquire` as chunk at `offset` of dataset with extent `dims`
+		void submit( char* ptr, const hsize_t* offset, const hsize_t* dims );
+		// sets extent of dataset from the calling thread, all submitted chunks must be written
+		void resize( const hsize_t* dims );
+		// rethrows the first error of the IO thread if any, called before handing over the next chunk
+		void check();
+		// blocks until all submitted chunks are written, then calls `check`
+		void drain();
+		void stop();
+		bool running() const { return io.joinable(); }
+
+		private:
+		struct job_t {
+			char* ptr;
+			hsize_t offset[H5CPP_MAX_RANK], dims[H5CPP_MAX_RANK];
+		};
+		void writer();
+
+		impl::basic_pipeline_t* pipeline;
+		::hid_t ds;
+		hsize_t rank, submitted, written,
+			extent; // along the first dimension, as last set successfully
+		bool done;
+		std::exception_ptr error;
+		std::vector<h5::impl::unique_ptr<char>> pool;
+		std::deque<char*> idle;
+		std::deque<job_t> queue;
+		std::thread io;
+		std::mutex mutex;
+		std::condition_variable on_submitted, on_written;
+	};
+
+	struct key_index_base_t {
+		virtual ~key_index_base_t(){}
+		// sets row of `chunk` to the key range of `n` records at `data`
+		virtual void add( hsize_t chunk, const char* data, size_t n ) = 0;
+		// writes pending rows
+		virtual void flush() = 0;
+	};
+	/* key range of each chunk of a packet table, kept in sidecar dataset `<path>.index` of {chunks,2} keys of type
+	 * `K`: lowest and highest key of the records in the chunk, the first and last one when appended in key order.
+	 * Keys are stored and compared as `K`, 64 bit integers such as nanosecond time stamps are exact.
+	 * Rows are written when the packet table is flushed or `batch` of them are pending; a partial chunk rewritten
+	 * by the packet table updates its row. See h5::key_index and h5::read_range
+	 */
+	template <class K>
+	struct key_index_t : public key_index_base_t {
+		static constexpr size_t batch = 256;
+		// opens or creates sidecar of packet table `ds`, the key of a record is at `offset`; created only for `empty` tables
+		key_index_t( const h5::ds_t& ds, size_t offset, size_t element_size, bool empty, impl::pt_writer_t* writer );
+		void add( hsize_t chunk, const char* data, size_t n );
+		void flush();
+
+		private:
+		h5::ds_t ds;
+		impl::pt_writer_t* writer; // of packet table, drained before rows are written
+		size_t offset, element_size;
+		hsize_t first; // chunk of the first pending row
+		std::vector<K> rows;
+	};
+	// path of sidecar key index of dataset `ds`
+	inline std::string index_path( ::hid_t ds ){
+		ssize_t length = H5Iget_name( ds, nullptr, 0 );
+		if( length <= 0 )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't get name of dataset..."));
+		std::string path( length, '\0' );
+		H5Iget_name( ds, &path[0], length + 1 );
+		return path + ".index";
+	}
+	template <class K> inline K key_of( const char* ptr ){
+		K key;
+		memcpy( &key, ptr, sizeof(K) );
+		return key;
+	}
+	template <class T, class K> inline size_t offset_of( K T::* member ){
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		const T* record = reinterpret_cast<const T*>( &storage );
+		return reinterpret_cast<const char*>( &(record->*member) ) - reinterpret_cast<const char*>( record );
+	}
+}}
+
 // packet table template specialization with inheritance
 namespace h5 {
 	struct pt_t {
@@ -28,33 +126,172 @@ namespace h5 {
 		friend std::ostream& ::operator<<(std::ostream &os, const h5::pt_t& pt);
 		template<class T>
 		friend void append( h5::pt_t& ds, const T& ref);
+		template<class T>
+		friend void append( h5::pt_t& ds, const T* first, size_t count);
+		template<class T, class K>
+		friend void key_index( h5::pt_t& pt, K T::* key );
+		friend struct h5::pt_manager_t;
 
 		void flush();
 
 		private:
+		// extends dataset to `current_dims` and writes chunk at `offset`, in the background when writer is running
+		void write_chunk( const void* data );
+		// writes chunk at `offset` and extends dataset in the order SWMR readers expect
+		void store( const void* data );
+		// counts `k` records appended in SWMR mode, flushes when due
+		void published( size_t k );
+		// writes full chunk cache `ptr` as next chunk, then starts a new one
+		void write_buffer();
+		// grows `extent` ahead of `current_dims` when it doesn't hold them, and the dataset along with it unless
+		// chunks are written in the background: then the extent is passed along with each chunk
+		void reserve();
+		// sets extent of dataset to `dims`
+		void resize( const hsize_t* dims );
+		// marks table as most recently appended, then makes sure it holds a chunk cache; see H5Dappend_manager.hpp
+		void touch();
+		// leaves manager, called by dtor
+		void release();
 		template<class T> inline typename std::enable_if<h5::impl::is_scalar<T>::value,
 		void>::type append( const T* ptr );
+		template<class T> inline typename std::enable_if<h5::impl::is_scalar<T>::value,
+		void>::type append( const T* first, size_t count );
 		template<class T> inline typename std::enable_if< h5::impl::is_scalar<T>::value && !std::is_pointer<T>::value,
 		void>::type append( const T& ref );
 		template<class T> inline typename std::enable_if< !h5::impl::is_scalar<T>::value,
 		void>::type append( const T& ref );
 
-		impl::pipeline_t<impl::basic_pipeline_t> pipeline;
+		impl::basic_pipeline_t pipeline;
+		impl::pt_writer_t writer; // stopped before pipeline is destroyed
 		h5::ds_t ds;
 		h5::dxpl_t dxpl;
 		hsize_t offset[H5CPP_MAX_RANK],
 			current_dims[H5CPP_MAX_RANK],
 			chunk_dims[H5CPP_MAX_RANK],
-			count[H5CPP_MAX_RANK];
+			count[H5CPP_MAX_RANK],
+			extent[H5CPP_MAX_RANK], // of dataset: current_dims and the space reserved ahead
+			max_extent; // limit of `extent` along the first dimension
 		size_t block_size,element_size,N,n,rank;
+		unsigned step; // chunks the dataset is extended by, 0 := double the extent
+		bool swmr; // extent is exact and flushed for readers, see h5::swmr_flush
+		hsize_t pending, flush_records; // records since last flush, and the most allowed
+		std::chrono::steady_clock::duration flush_interval;
+		std::chrono::steady_clock::time_point flushed;
+		h5::impl::unique_ptr<char> buffer; // chunk cache when there is no background writer
+		std::unique_ptr<impl::key_index_base_t> index; // optional, see h5::key_index
+		h5::pt_manager_t* manager; // optional, chunk cache is taken away and given back by manager
+		std::list<h5::pt_t*>::iterator entry, resident; // position in the lists of manager
 		void *ptr;
 	};
 }
 
+inline void h5::impl::pt_writer_t::start( impl::basic_pipeline_t* pipeline, ::hid_t ds, unsigned depth, hsize_t rank,
+		const hsize_t* dims ){
+	this->pipeline = pipeline, this->ds = ds, this->rank = rank, this->extent = *dims;
+	for( unsigned i=0; i<depth + 1; i++ ){
+		pool.emplace_back( (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, pipeline->buffer_size ) );
+		if( !pool.back() ){
+			pool.clear(); idle.clear();
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+		}
+		idle.push_back( pool.back().get() );
+	}
+	submitted = written = 0, done = false;
+	io = std::thread( &pt_writer_t::writer, this );
+}
+
+inline void h5::impl::pt_writer_t::stop(){
+	if( !io.joinable() ) return;
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		done = true;
+	}
+	on_submitted.notify_all();
+	io.join();
+	queue.clear(); idle.clear(); pool.clear();
+}
+
+inline void h5::impl::pt_writer_t::writer(){
+	for(;;){
+		std::unique_lock<std::mutex> lock( mutex );
+		on_submitted.wait( lock, [this]{ return done || !queue.empty(); } );
+		if( queue.empty() ) return;
+		job_t job = queue.front();
+		queue.pop_front();
+		bool skip = error != nullptr;
+		lock.unlock();
+		// once failed, the remaining chunks are dropped until error is picked up by drain
+		if( !skip ) try {
+			if( *job.dims != extent ){ // retried with the next chunk when failed
+				H5CPP_CHECK_NZ( H5Dset_extent( ds, job.dims ), h5::error::io::dataset::append, h5::error::msg::set_extent );
+				extent = *job.dims;
+			}
+			pipeline->write_chunk( job.offset, pipeline->block_size, job.ptr );
+		} catch ( ... ){
+			H5Eclear2( H5E_DEFAULT ); // error stack of this thread would keep the library from closing
+			lock.lock();
+			error = std::current_exception();
+			lock.unlock();
+		}
+		lock.lock();
+		idle.push_back( job.ptr );
+		written++;
+		lock.unlock();
+		on_written.notify_all();
+	}
+}
+
+inline char* h5::impl::pt_writer_t::acquire(){
+	std::unique_lock<std::mutex> lock( mutex );
+	on_written.wait( lock, [this]{ return !idle.empty(); } );
+	char* ptr = idle.front();
+	idle.pop_front();
+	return ptr;
+}
+
+inline void h5::impl::pt_writer_t::submit( char* ptr, const hsize_t* offset, const hsize_t* dims ){
+	job_t job;
+	job.ptr = ptr;
+	std::copy( offset, offset + rank, job.offset );
+	std::copy( dims, dims + rank, job.dims );
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		queue.push_back( job );
+		submitted++;
+	}
+	on_submitted.notify_one();
+}
+
+inline void h5::impl::pt_writer_t::resize( const hsize_t* dims ){
+	H5CPP_CHECK_NZ( H5Dset_extent( ds, dims ), h5::error::io::dataset::append, h5::error::msg::set_extent );
+	std::lock_guard<std::mutex> lock( mutex );
+	extent = *dims;
+}
+
+inline void h5::impl::pt_writer_t::drain(){
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		on_written.wait( lock, [this]{ return written == submitted; } );
+	}
+	check();
+}
+
+inline void h5::impl::pt_writer_t::check(){
+	std::unique_lock<std::mutex> lock( mutex );
+	std::exception_ptr error_ = error;
+	error = nullptr;
+	lock.unlock();
+	if( error_ ) try {
+		std::rethrow_exception( error_ );
+	} catch ( const std::exception& err ){
+		throw h5::error::io::packet_table::write( err.what() );
+	}
+}
+
 /* initialized to invalid state
  * */
 inline h5::pt_t::pt_t() :
-	dxpl{H5Pcreate(H5P_DATASET_XFER)},ds{H5I_UNINIT},n{0}{
+	dxpl{H5Pcreate(H5P_DATASET_XFER)},ds{H5I_UNINIT},n{0},swmr{false},pending{0},manager{nullptr},ptr{nullptr}{
 		for( int i=0; i<H5CPP_MAX_RANK; i++ )
 			count[i] = 1, offset[i] = 0;
 	}
@@ -70,19 +307,55 @@ h5::pt_t::pt_t( const h5::ds_t& handle ) : pt_t() {
 
 		h5::sp_t file_space = h5::get_space( handle );
 		rank = h5::get_simple_extent_dims( file_space, current_dims, nullptr );
+		hsize_t max_dims[H5CPP_MAX_RANK];
+		H5Sget_simple_extent_dims( static_cast<::hid_t>( file_space ), nullptr, max_dims );
+		max_extent = *max_dims;
 
 		h5::dcpl_t dcpl = h5::get_dcpl( ds );
 		h5::dt_t<void*> type = h5::get_type<void*>( ds );
 		hsize_t size = h5::get_size( type );
 		pipeline.set_cache(dcpl, size );
-		this->ptr = pipeline.chunk0;
 		this->block_size = pipeline.block_size;
 		this->element_size = pipeline.element_size;
 		this->N = pipeline.n;
-		pipeline.ds = ds; pipeline.dxpl = dxpl;
+		pipeline.ds = static_cast<::hid_t>( ds ); pipeline.dxpl = static_cast<::hid_t>( dxpl );
 		h5::get_chunk_dims( dcpl, chunk_dims );
 		for(int i=1; i<rank; i++)
 			current_dims[i] = chunk_dims[i];
+		std::copy( current_dims, current_dims + rank, extent );
+		H5D_alloc_time_t alloc_time;
+		H5Pget_alloc_time( static_cast<::hid_t>( dcpl ), &alloc_time );
+		// space reserved ahead would be allocated right away
+		step = alloc_time == H5D_ALLOC_TIME_EARLY ? 1 : impl::get_reserve( handle.dapl );
+		impl::swmr_flush_t policy;
+		if( (swmr = impl::get_swmr( handle.dapl, policy )) ){
+			flush_records = policy.records ? policy.records : std::numeric_limits<hsize_t>::max();
+			flush_interval = std::chrono::milliseconds( policy.milliseconds );
+			flushed = std::chrono::steady_clock::now();
+		}
+		auto async = dynamic_cast<impl::async_pipeline_t*>( impl::get_pipeline( handle.dapl ) );
+		if( async && swmr )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("packet table in SWMR mode is written synchronously..."));
+		bool background = async != nullptr;
+#ifndef H5CPP_HAVE_THREADSAFE_IO
+		background = false; // the serial library may be called from one thread only
+#endif
+		if( background ){
+			writer.start( &pipeline, static_cast<::hid_t>( ds ), async->depth, rank, extent );
+			this->ptr = writer.acquire();
+		} else { // filters use chunk0 and chunk1 of pipeline as scratch, records are kept apart
+			buffer = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, pipeline.buffer_size )};
+			if( !(this->ptr = buffer.get()) )
+				throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+		}
+		if( hsize_t rows = *current_dims % *chunk_dims ){ // partial chunk left by flush: continue filling it
+			size_t r=1; for(int i=1; i<rank; i++) r*=chunk_dims[i];
+			*current_dims -= rows, n = rows * r;
+			*offset = *current_dims;
+			pipeline.read_chunk( offset, block_size, ptr );
+		}
+	} catch ( const h5::error::io::packet_table::any& err ){
+		throw;
 	} catch ( ... ){
 		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("CTOR: unable to create handle from dataset..."));
 	}
@@ -93,7 +366,13 @@ h5::pt_t::~pt_t(){
 	/*default ctor has an invalid state -- skip flushing cache */
 	if( !h5::is_valid( ds ) )
 		return;
-	flush();
+	try { // dtor must not throw: records lost at this point are reported as unrecoverable
+		flush();
+	} catch ( const std::exception& err ){
+		h5::error::io::packet_table::rollback( err.what() );
+	}
+	writer.stop();
+	if( manager ) release();
 }
 
 template<class T> inline typename std::enable_if< h5::impl::is_scalar<T>::value,
@@ -101,8 +380,8 @@ void>::type h5::pt_t::append( const T* ptr ) try {
 	//PTR: write directly chunk size from provided buffer/ptr
 	*offset = *current_dims;
 	*current_dims += *chunk_dims;
-	h5::set_extent(ds, current_dims);
-	pipeline.write_chunk(offset,block_size,ptr);
+	write_chunk( ptr );
+	if( swmr ) published( N );
 } catch( const std::runtime_error& err ){
 	throw h5::error::io::dataset::append( err.what() );
 }
@@ -110,15 +389,35 @@ void>::type h5::pt_t::append( const T* ptr ) try {
 template<class T> inline typename std::enable_if< h5::impl::is_scalar<T>::value && !std::is_pointer<T>::value,
 void>::type h5::pt_t::append( const T& ref ) try {
 //SCALAR: store inbound data directly in pipeline cache
+	if( manager ) touch();
 	static_cast<T*>( ptr )[n++] = ref;
 
-	if( n != N ) return;
+	if( n == N ) write_buffer();
+	if( swmr ) published( 1 );
+} catch( const std::runtime_error& err ){
+	throw h5::error::io::dataset::append( err.what() );
+}
 
-	n = 0;
-	*offset = *current_dims;
-	*current_dims += *chunk_dims;
-	h5::set_extent(ds, current_dims);
-	pipeline.write_chunk(offset,block_size,ptr);
+template<class T> inline typename std::enable_if< h5::impl::is_scalar<T>::value,
+void>::type h5::pt_t::append( const T* first, size_t count ) try {
+//RANGE: top up chunk cache, then whole chunks directly from provided memory, the remainder is cached
+	const char* src = reinterpret_cast<const char*>( first );
+	if( count == 0 ) return;
+	if( manager ) touch();
+	if( n ){
+		size_t k = std::min( N - n, count );
+		memcpy( static_cast<char*>( ptr ) + n * element_size, src, k * element_size );
+		n += k, count -= k, src += k * element_size;
+		if( n == N ) write_buffer();
+	}
+	for( ; count >= N; count -= N, src += block_size ){
+		*offset = *current_dims;
+		*current_dims += *chunk_dims;
+		write_chunk( src );
+	}
+	if( count ) // chunk cache is empty at this point
+		memcpy( ptr, src, count * element_size ), n = count;
+	if( swmr ) published( (src - reinterpret_cast<const char*>( first )) / element_size + count );
 } catch( const std::runtime_error& err ){
 	throw h5::error::io::dataset::append( err.what() );
 }
@@ -129,28 +428,27 @@ void>::type h5::pt_t::append( const T& ref ) try {
 
 	*offset = *current_dims;
 	*current_dims += 1;
-	h5::set_extent(ds, current_dims);
 	auto ptr_ = impl::data( ref );
 	auto dims_ = impl::size( ref );
 
 	switch( dims_.size() ){
 		case 1: // vector
 			if( dims[0] * element_size == block_size )
-				pipeline.write_chunk(offset, block_size, (void*) ptr_ );
+				write_chunk( ptr_ );
 			else throw h5::error::io::packet_table::write(
 					H5CPP_ERROR_MSG("dimension mismatch: "
 						+ std::to_string( dims[0] * element_size) + " != " + std::to_string(block_size) ));
 			break;
 		case 2: //matrix
 			if( dims[0] * dims[1] * element_size == block_size )
-				pipeline.write_chunk(offset, block_size, (void*) ptr_ );
+				write_chunk( ptr_ );
 			else throw h5::error::io::packet_table::write(
 					H5CPP_ERROR_MSG("dimension mismatch: "
 						+ std::to_string( dims[0] * dims[1] * element_size) + " != " + std::to_string(block_size) ));
 			break;
 		case 3: // cube
 			if( dims[0] * dims[1] * dims[2] * element_size == block_size )
-				pipeline.write_chunk(offset, block_size, (void*) ptr_ );
+				write_chunk( ptr_ );
 			else throw h5::error::io::packet_table::write(
 					H5CPP_ERROR_MSG("dimension mismatch: "
 						+ std::to_string( dims[0] * dims[1] * dims[2] * element_size) + " != " + std::to_string(block_size) ));
@@ -159,23 +457,165 @@ void>::type h5::pt_t::append( const T& ref ) try {
 			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("objects with rank > 2 are not supported... "));
 	}
 	//pipeline.write_chunk(offset,block_size, (void*) ptr_ );
+	if( swmr ) published( N );
 
 } catch( const std::runtime_error& err ){
 	throw h5::error::io::dataset::append( err.what() );
 }
 
 inline
-void h5::pt_t::flush(){
-	if( n == 0 ) return;
-	// the remainder of last chunk is zeroed out:
-	memset(
-			static_cast<char*>( ptr ) + n*element_size, 0, (N-n) * element_size);
+void h5::pt_t::write_chunk( const void* data ){
+	if( index ) index->add( *offset / *chunk_dims, static_cast<const char*>( data ), N );
+	if( writer.running() ){ // caller may reuse `data` on return: copy
+		writer.check();
+		char* buffer = writer.acquire();
+		memcpy( buffer, data, block_size );
+		reserve();
+		writer.submit( buffer, offset, extent );
+		return;
+	}
+	store( data );
+}
+
+inline
+void h5::pt_t::store( const void* data ){
+	// readers may pick up the extent any time: a chunk they can see already is updated first, a new chunk
+	// can only be written into the extent, and is skipped by h5::pt_tail until it is allocated
+	if( swmr && *offset < *extent ){
+		pipeline.write_chunk( offset, block_size, data );
+		reserve();
+		return;
+	}
+	reserve();
+	pipeline.write_chunk( offset, block_size, data );
+}
+
+inline
+void h5::pt_t::published( size_t k ){
+	pending += k;
+	if( pending < flush_records && ( flush_interval.count() == 0
+				|| std::chrono::steady_clock::now() - flushed < flush_interval ) ) return;
+	flush();
+}
+
+inline
+void h5::pt_t::reserve(){
+	if( *current_dims <= *extent ) return;
+	hsize_t last = *extent;
+	// geometric growth: O(log n) extent changes for n chunks, none ahead for SWMR readers
+	*extent = swmr ? *current_dims : std::max( *current_dims, *extent + (step ? step * *chunk_dims : *extent) );
+	if( max_extent != H5S_UNLIMITED )
+		*extent = std::max( *current_dims, std::min( *extent, max_extent ) );
+	for(int i=1; i<rank; i++)
+		extent[i] = current_dims[i];
+	if( writer.running() ) return;
+	try {
+		h5::set_extent(ds, extent);
+	} catch ( ... ){ // retried with the next chunk
+		*extent = last;
+		throw;
+	}
+}
+
+inline
+void h5::pt_t::resize( const hsize_t* dims ){
+	if( writer.running() ) writer.resize( dims );
+	else h5::set_extent(ds, dims);
+	std::copy( dims, dims + rank, extent );
+}
+
+inline
+void h5::pt_t::write_buffer(){
+	n = 0;
 	*offset = *current_dims;
-	*current_dims += *current_dims % *chunk_dims;
+	*current_dims += *chunk_dims;
+	if( index ) index->add( *offset / *chunk_dims, static_cast<const char*>( ptr ), N );
+	if( writer.running() ){ // swap buffers, chunk is extended and written in the background
+		writer.check();
+		reserve();
+		writer.submit( static_cast<char*>( ptr ), offset, extent );
+		ptr = writer.acquire();
+		return;
+	}
+	store( ptr );
+}
+
+inline
+void h5::pt_t::flush(){
+	if( writer.running() ) writer.drain();
+	// dataset is set to the exact length, records of partial chunk are kept in cache and the chunk is
+	// rewritten when flushed again or filled up; only a partial row of a rank > 1 table is padded
 	size_t r=1; for(int i=1; i<rank; i++) r*=chunk_dims[i];
-	*current_dims += (n % r) ? n / r + 1 : n / r;
-	h5::set_extent(ds, current_dims);
-	pipeline.write_chunk( offset, block_size, ptr );
+	hsize_t dims[H5CPP_MAX_RANK];
+	std::copy( current_dims, current_dims + rank, dims );
+	*dims += (n + r - 1) / r;
+	// SWMR readers see a partial chunk already on disk: it is rewritten before the extent grows
+	bool visible = swmr && *extent > *current_dims;
+	if( *extent != *dims && !visible ) resize( dims ); // space reserved ahead is released
+	// a table evicted by its manager has the partial chunk on disk, and no cache
+	if( n && ptr ){ // the remainder of last chunk is zeroed out:
+		memset(
+				static_cast<char*>( ptr ) + n*element_size, 0, (N-n) * element_size);
+		*offset = *current_dims;
+		pipeline.write_chunk( offset, block_size, ptr );
+		if( index ) index->add( *offset / *chunk_dims, static_cast<const char*>( ptr ), n );
+	}
+	if( *extent != *dims && visible ) resize( dims );
+	if( index ) index->flush();
+	if( !swmr ) return;
+	H5CPP_CHECK_NZ( H5Dflush( static_cast<::hid_t>( ds ) ), h5::error::io::packet_table::write, "couldn't flush dataset...");
+	pending = 0, flushed = std::chrono::steady_clock::now();
+}
+
+template <class K> inline
+h5::impl::key_index_t<K>::key_index_t( const h5::ds_t& handle, size_t offset, size_t element_size, bool empty,
+		impl::pt_writer_t* writer ) : writer( writer ), offset( offset ), element_size( element_size ), first(0) {
+	if( writer->running() ) writer->drain();
+	std::string path = index_path( static_cast<::hid_t>( handle ) );
+	h5::fd_t fd{ H5Iget_file_id( static_cast<::hid_t>( handle ) ) };
+	if( H5Lexists( static_cast<::hid_t>( fd ), path.data(), H5P_DEFAULT ) > 0 )
+		ds = h5::open( fd, path );
+	else if( !empty )
+		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("key index must be set before appending records..."));
+	else
+		ds = h5::create<K>( fd, path, h5::current_dims{0,2}, h5::max_dims{H5S_UNLIMITED,2}, h5::chunk{batch,2} );
+}
+
+template <class K> inline
+void h5::impl::key_index_t<K>::add( hsize_t chunk, const char* data, size_t n ){
+	if( !rows.empty() && (chunk < first || chunk > first + rows.size() / 2) ) flush();
+	if( rows.empty() ) first = chunk;
+	K lo = std::numeric_limits<K>::max(), hi = std::numeric_limits<K>::lowest();
+	for( size_t i=0; i<n; i++ ){
+		K k = key_of<K>( data + i * element_size + offset );
+		lo = std::min( lo, k ), hi = std::max( hi, k );
+	}
+	size_t i = 2 * (chunk - first);
+	if( i == rows.size() ) rows.push_back( lo ), rows.push_back( hi );
+	else rows[i] = lo, rows[i+1] = hi;
+	if( rows.size() >= 2 * batch ) flush();
+}
+
+template <class K> inline
+void h5::impl::key_index_t<K>::flush(){
+	if( rows.empty() ) return;
+	if( writer->running() ) writer->drain(); // IO thread may be in H5Dwrite_chunk
+	hsize_t count = rows.size() / 2, dims[2];
+	h5::sp_t space = h5::get_space( ds );
+	h5::get_simple_extent_dims( space, dims, nullptr );
+	if( first + count > *dims ){
+		hsize_t extent[2] = { first + count, 2 };
+		h5::set_extent( ds, extent );
+	}
+	hsize_t start[2] = { first, 0 }, size[2] = { count, 2 };
+	h5::sp_t file_space{ H5Dget_space( static_cast<::hid_t>( ds ) ) };
+	h5::sp_t mem_space{ H5Screate_simple( 2, size, nullptr ) };
+	H5Sselect_hyperslab( static_cast<::hid_t>( file_space ), H5S_SELECT_SET, start, nullptr, size, nullptr );
+	h5::dt_t<K> type;
+	H5CPP_CHECK_NZ( H5Dwrite( static_cast<::hid_t>( ds ), static_cast<::hid_t>( type ), static_cast<::hid_t>( mem_space ),
+				static_cast<::hid_t>( file_space ), H5P_DEFAULT, rows.data() ),
+			h5::error::io::packet_table::write, "couldn't write key index...");
+	rows.clear();
 }
 
 namespace h5 {
@@ -190,12 +630,46 @@ namespace h5 {
 	void append( h5::pt_t& pt, const T& ref){
 		pt.append( ref );
 	}
+	/** @ingroup io-append
+	 * @brief appends `count` records from contiguous memory: chunks filled entirely by the range are written
+	 * directly from there, the rest is copied into the chunk cache 
+	 * @param pt packet_table descriptor
+	 * @param first pointer to the first record
+	 * @param count number of records
+	 * @tparam T element type of packet table
+	 */
+	template<class T> inline
+	void append( h5::pt_t& pt, const T* first, size_t count ){
+		pt.append( first, count );
+	}
+	/** @ingroup io-append
+	 * @brief appends records of contiguous range [first, last), see append( pt, first, count )
+	 */
+	template<class T> inline
+	void append( h5::pt_t& pt, const T* first, const T* last ){
+		h5::append( pt, first, static_cast<size_t>( last - first ) );
+	}
 
 	inline void flush( h5::pt_t& pt) try {
 		pt.flush( );
 	} catch ( const std::runtime_error& e){
 		throw h5::error::io::dataset::close( e.what() );
 	}
+	/** @ingroup io-append
+	 * @brief maintains key range of each chunk in sidecar dataset `<path>.index`, for h5::read_range to find
+	 * the chunks of a key range with binary search; set on an empty or already indexed table
+	 * @param pt packet_table descriptor of rank 1
+	 * @param key member of `T` records are appended in the order of
+	 * @tparam T element type of packet table
+	 */
+	template<class T, class K> inline
+	void key_index( h5::pt_t& pt, K T::* key ){
+		static_assert( std::is_arithmetic<K>::value, "key must be of arithmetic type" );
+		if( pt.rank != 1 || pt.element_size != sizeof(T) )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("key index requires rank 1 table of the record type..."));
+		pt.index.reset( new impl::key_index_t<K>( pt.ds, impl::offset_of( key ), pt.element_size,
+					*pt.current_dims == 0 && pt.n == 0, &pt.writer ) );
+	}
 }
 
 inline std::ostream& operator<<(std::ostream &os, const h5::pt_t& pt) {
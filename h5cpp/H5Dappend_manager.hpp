@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#ifndef  H5CPP_DAPPEND_MANAGER_HPP
+#define H5CPP_DAPPEND_MANAGER_HPP
+
+/* packet table manager: keeps the chunk caches of many h5::pt_t within a byte budget. Filter scratch of the
+ * attached tables is shared, and a table holds a chunk cache only while it has records pending; when the next
+ * one doesn't fit, the least recently appended tables are flushed -- the partial chunk written at the exact
+ * extent -- and give up theirs. The partial chunk is read back once the table is appended to again.
+ * Tables are written synchronously, and must be used from the same thread as the manager. The budget is
+ * exceeded only when a single chunk cache and the scratch don't fit in it.
+ *   h5::pt_manager_t manager( 1ull<<30 );
+ *   std::deque<h5::pt_t> pt; // one per instrument
+ *   for(...) pt.emplace_back( h5::create<tick>(fd, name, ...) ), manager.attach( pt.back() );
+ *   h5::append(pt[i], record);
+ */
+namespace h5 {
+	struct pt_manager_t {
+		pt_manager_t( size_t budget ) : budget( budget ), size_(0), scratch_size(0), evictions_(0) {}
+		pt_manager_t( const pt_manager_t& ) = delete;
+		pt_manager_t& operator=( const pt_manager_t& ) = delete;
+		// remaining tables are detached
+		~pt_manager_t();
+
+		// shares filter scratch with `pt`, its chunk cache is given up when empty
+		void attach( h5::pt_t& pt );
+		// table is given back own scratch and chunk cache
+		void detach( h5::pt_t& pt );
+		// bytes of chunk caches and scratch held
+		size_t size() const { return size_; }
+		// tables flushed to make room so far
+		size_t evictions() const { return evictions_; }
+
+		const size_t budget;
+
+		private:
+		friend struct h5::pt_t;
+		void touch( h5::pt_t* pt ){
+			if( !pt->ptr ) acquire( pt );
+			else if( resident.begin() != pt->resident ) resident.splice( resident.begin(), resident, pt->resident );
+		}
+		// chunk cache for `pt`, taken from the least recently appended tables when over budget
+		void acquire( h5::pt_t* pt );
+		// flushes `pt` then takes its chunk cache
+		h5::impl::unique_ptr<char> evict( h5::pt_t* pt );
+		// removes `pt` from the lists, its cache is released by the caller
+		void release( h5::pt_t* pt );
+
+		std::list<h5::pt_t*> tables, // attached
+			resident; // holding a chunk cache, most recently appended first
+		h5::impl::unique_ptr<char> scratch0, scratch1;
+		size_t size_, scratch_size, evictions_;
+	};
+}
+
+inline h5::pt_manager_t::~pt_manager_t(){
+	while( !tables.empty() ){
+		h5::pt_t* pt = tables.front();
+		try {
+			detach( *pt );
+		} catch ( const std::exception& err ){
+			if( pt->manager == this ) release( pt );
+			h5::error::io::packet_table::rollback( err.what() );
+		}
+	}
+}
+
+inline void h5::pt_manager_t::attach( h5::pt_t& pt ){
+	if( pt.manager == this ) return;
+	if( pt.manager || !h5::is_valid( pt.ds ) || pt.writer.running() )
+		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("table must be synchronous and not managed already..."));
+	size_t buffer_size = pt.pipeline.buffer_size;
+	if( buffer_size > scratch_size ){ // tables attached so far are moved to the larger scratch
+		h5::impl::unique_ptr<char>
+			a{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )},
+			b{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		if( !a || !b )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't allocate memory for scratch..."));
+		for( h5::pt_t* table : tables )
+			table->pipeline.set_scratch( a.get(), b.get() );
+		size_ += 2 * (buffer_size - scratch_size);
+		scratch0 = std::move( a ), scratch1 = std::move( b ), scratch_size = buffer_size;
+	}
+	pt.pipeline.set_scratch( scratch0.get(), scratch1.get() );
+	tables.push_front( &pt );
+	pt.entry = tables.begin();
+	pt.manager = this;
+	if( pt.n ){ // pending records are kept
+		resident.push_front( &pt );
+		pt.resident = resident.begin();
+		size_ += buffer_size;
+	} else
+		pt.buffer.reset(), pt.ptr = nullptr;
+}
+
+inline void h5::pt_manager_t::detach( h5::pt_t& pt ){
+	if( pt.manager != this ) return;
+	release( &pt );
+	pt.pipeline.set_scratch( nullptr, nullptr );
+	if( pt.ptr ) return;
+	pt.buffer = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, pt.pipeline.buffer_size )};
+	if( !(pt.ptr = pt.buffer.get()) )
+		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+	if( pt.n ){
+		*pt.offset = *pt.current_dims;
+		pt.pipeline.read_chunk( pt.offset, pt.block_size, pt.ptr );
+	}
+}
+
+inline void h5::pt_manager_t::release( h5::pt_t* pt ){
+	if( pt->ptr ){
+		resident.erase( pt->resident );
+		size_ -= pt->pipeline.buffer_size;
+	}
+	tables.erase( pt->entry );
+	pt->manager = nullptr;
+}
+
+inline h5::impl::unique_ptr<char> h5::pt_manager_t::evict( h5::pt_t* pt ){
+	pt->flush();
+	resident.erase( pt->resident );
+	pt->ptr = nullptr;
+	evictions_++;
+	return std::move( pt->buffer );
+}
+
+inline void h5::pt_manager_t::acquire( h5::pt_t* pt ){
+	size_t buffer_size = pt->pipeline.buffer_size;
+	h5::impl::unique_ptr<char> buffer;
+	while( !buffer && size_ + buffer_size > budget && !resident.empty() ){
+		h5::pt_t* victim = resident.back();
+		h5::impl::unique_ptr<char> spare = evict( victim );
+		if( victim->pipeline.buffer_size == buffer_size ) buffer = std::move( spare );
+		else size_ -= victim->pipeline.buffer_size;
+	}
+	if( !buffer ){
+		buffer = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		if( !buffer )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+		size_ += buffer_size;
+	}
+	pt->buffer = std::move( buffer );
+	pt->ptr = pt->buffer.get();
+	resident.push_front( pt );
+	pt->resident = resident.begin();
+	if( pt->n ){ // partial chunk written when evicted
+		*pt->offset = *pt->current_dims;
+		pt->pipeline.read_chunk( pt->offset, pt->block_size, pt->ptr );
+	}
+}
+
+inline void h5::pt_t::touch(){
+	manager->touch( this );
+}
+inline void h5::pt_t::release(){
+	manager->release( this );
+}
+#endif
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#ifndef  H5CPP_DAPPEND_MP_HPP
+#define H5CPP_DAPPEND_MP_HPP
+
+/* multi-producer packet table: any number of threads append records to the same dataset. A producer reserves
+ * the next slot of the chunk being filled with an atomic cursor and copies its record there, no lock taken;
+ * the producer completing the chunk hands it over to the IO thread of impl::pt_writer_t, then publishes the
+ * next buffer by resetting the cursor. Producers arriving at a full chunk wait for this to happen.
+ * Records within a chunk are in reservation order, chunks are in the order they were filled. Depth of the IO
+ * queue is taken from h5::async_write{depth} when present on the dapl. `flush` and dtor must not run
+ * concurrently with `append`. Without H5CPP_HAVE_THREADSAFE_IO there is no IO thread: the producer sealing a
+ * chunk writes it before publishing the next one, the others wait meanwhile.
+ */
+namespace h5 {
+	struct mpt_t {
+		mpt_t( const h5::ds_t& handle ); // conversion ctor
+		mpt_t( const h5::mpt_t& ) = delete;
+		mpt_t& operator=( const h5::mpt_t& ) = delete;
+		~mpt_t();
+
+		template<class T>
+		friend void append( h5::mpt_t& pt, const T& ref );
+		// sets dataset to the exact length, partial chunk is kept and rewritten once filled or flushed again
+		void flush();
+
+		private:
+		template<class T> inline typename std::enable_if< h5::impl::is_scalar<T>::value && !std::is_pointer<T>::value,
+		void>::type append( const T& ref );
+		// hands over full chunk cache to IO thread then publishes the next one, called by a single producer
+		void seal();
+
+		impl::basic_pipeline_t pipeline;
+		impl::pt_writer_t writer; // stopped before pipeline is destroyed
+		h5::ds_t ds;
+		h5::dxpl_t dxpl;
+		hsize_t offset[H5CPP_MAX_RANK],
+			current_dims[H5CPP_MAX_RANK], // start of the chunk being filled
+			chunk_dims[H5CPP_MAX_RANK],
+			extent[H5CPP_MAX_RANK],
+			max_extent;
+		size_t block_size,element_size,N,rank;
+		unsigned step; // chunks the dataset is extended by, 0 := double the extent
+		char* ptr; // written by sealing producer before cursor is reset
+		h5::impl::unique_ptr<char> buffer; // chunk cache when there is no IO thread
+		std::atomic<size_t> cursor, // next free slot, may run past N while the chunk is sealed
+			committed; // slots with record copied
+	};
+}
+
+inline
+h5::mpt_t::mpt_t( const h5::ds_t& handle ) :
+	dxpl{H5Pcreate(H5P_DATASET_XFER)}, ptr(nullptr), cursor(0), committed(0) {
+	try {
+		ds = handle;
+		h5::sp_t file_space = h5::get_space( handle );
+		rank = h5::get_simple_extent_dims( file_space, current_dims, nullptr );
+		hsize_t max_dims[H5CPP_MAX_RANK];
+		H5Sget_simple_extent_dims( static_cast<::hid_t>( file_space ), nullptr, max_dims );
+		max_extent = *max_dims;
+
+		h5::dcpl_t dcpl = h5::get_dcpl( ds );
+		h5::dt_t<void*> type = h5::get_type<void*>( ds );
+		pipeline.set_cache(dcpl, h5::get_size( type ) );
+		block_size = pipeline.block_size, element_size = pipeline.element_size, N = pipeline.n;
+		pipeline.ds = static_cast<::hid_t>( ds ); pipeline.dxpl = static_cast<::hid_t>( dxpl );
+		h5::get_chunk_dims( dcpl, chunk_dims );
+		for(int i=1; i<rank; i++)
+			current_dims[i] = chunk_dims[i];
+		std::copy( current_dims, current_dims + rank, extent );
+		for( int i=0; i<H5CPP_MAX_RANK; i++ ) offset[i] = 0;
+		H5D_alloc_time_t alloc_time;
+		H5Pget_alloc_time( static_cast<::hid_t>( dcpl ), &alloc_time );
+		step = alloc_time == H5D_ALLOC_TIME_EARLY ? 1 : impl::get_reserve( handle.dapl );
+
+#ifdef H5CPP_HAVE_THREADSAFE_IO
+		auto async = dynamic_cast<impl::async_pipeline_t*>( impl::get_pipeline( handle.dapl ) );
+		writer.start( &pipeline, static_cast<::hid_t>( ds ), async && async->depth ? async->depth : 2, rank, extent );
+		ptr = writer.acquire();
+#else // the serial library may be called from one thread only
+		buffer = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, pipeline.buffer_size )};
+		if( !(ptr = buffer.get()) )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+#endif
+		if( hsize_t rows = *current_dims % *chunk_dims ){ // partial chunk left by flush: continue filling it
+			size_t r=1; for(int i=1; i<rank; i++) r*=chunk_dims[i];
+			*current_dims -= rows;
+			*offset = *current_dims;
+			pipeline.read_chunk( offset, block_size, ptr );
+			cursor = committed = rows * r;
+		}
+	} catch ( ... ){
+		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("CTOR: unable to create handle from dataset..."));
+	}
+}
+
+inline
+h5::mpt_t::~mpt_t(){
+	try { // dtor must not throw: records lost at this point are reported as unrecoverable
+		flush();
+	} catch ( const std::exception& err ){
+		h5::error::io::packet_table::rollback( err.what() );
+	}
+	writer.stop();
+}
+
+template<class T> inline typename std::enable_if< h5::impl::is_scalar<T>::value && !std::is_pointer<T>::value,
+void>::type h5::mpt_t::append( const T& ref ) {
+	for(;;){
+		size_t i = cursor.fetch_add( 1, std::memory_order_acquire );
+		if( i < N ){
+			memcpy( ptr + i * element_size, &ref, element_size );
+			if( committed.fetch_add( 1, std::memory_order_acq_rel ) + 1 == N )
+				seal();
+			return;
+		}
+		// chunk is being sealed: wait for the next one
+		while( cursor.load( std::memory_order_relaxed ) >= N )
+			std::this_thread::yield();
+	}
+}
+
+inline
+void h5::mpt_t::seal(){
+	*offset = *current_dims;
+	*current_dims += *chunk_dims;
+	hsize_t last = *extent;
+	if( *current_dims > *extent ){ // geometric growth, same as h5::pt_t
+		*extent = std::max( *current_dims, *extent + (step ? step * *chunk_dims : *extent) );
+		if( max_extent != H5S_UNLIMITED )
+			*extent = std::max( *current_dims, std::min( *extent, max_extent ) );
+	}
+	std::exception_ptr error;
+	if( writer.running() ){
+		writer.submit( ptr, offset, extent );
+		ptr = writer.acquire();
+	} else try { // written from the cache before it is published again
+		if( *extent != last ) try {
+			h5::set_extent( ds, extent );
+		} catch ( ... ){ // retried with the next chunk
+			*extent = last;
+			throw;
+		}
+		pipeline.write_chunk( offset, block_size, ptr );
+	} catch ( ... ){
+		error = std::current_exception();
+	}
+	committed.store( 0, std::memory_order_relaxed );
+	cursor.store( 0, std::memory_order_release );
+	// failed chunks are reported to the producer sealing them -- or the next one when written in the background --
+	// after publishing the next chunk
+	try {
+		if( error ) std::rethrow_exception( error );
+		writer.check();
+	} catch( const std::runtime_error& err ){
+		throw h5::error::io::dataset::append( err.what() );
+	}
+}
+
+inline
+void h5::mpt_t::flush(){
+	if( writer.running() ) writer.drain();
+	size_t n = committed.load( std::memory_order_acquire );
+	size_t r=1; for(int i=1; i<rank; i++) r*=chunk_dims[i];
+	hsize_t dims[H5CPP_MAX_RANK];
+	std::copy( current_dims, current_dims + rank, dims );
+	*dims += (n + r - 1) / r;
+	if( *extent != *dims ){ // space reserved ahead is released
+		if( writer.running() ) writer.resize( dims );
+		else h5::set_extent( ds, dims );
+		std::copy( dims, dims + rank, extent );
+	}
+	if( n == 0 ) return;
+	memset( ptr + n*element_size, 0, (N-n) * element_size);
+	*offset = *current_dims;
+	pipeline.write_chunk( offset, block_size, ptr );
+}
+
+namespace h5 {
+	/** @ingroup io-append
+	 * @brief appends record to multi-producer packet table, may be called from any number of threads
+	 * @param pt multi-producer packet table descriptor
+	 * @param ref record to append
+	 * @tparam T element type of dataset
+	 */
+	template<class T> inline void append( h5::mpt_t& pt, const T& ref ){
+		pt.append( ref );
+	}
+}
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#ifndef  H5CPP_DCOLUMNS_HPP
+#define H5CPP_DCOLUMNS_HPP
+
+/* columnar packet table: each field of a compound record registered with h5::register_struct<T>() is kept in a
+ * dataset of its own, named after the field, within group `path`. Fields of the same kind compress better than
+ * interleaved records, and scanning a field reads only its own chunks. Columns are created with the passed dcpl,
+ * which must specify chunked layout, or reopened when present, then appended to as with h5::pt_t.
+ *   h5::cpt_t<tick> pt(fd, "ticks", h5::chunk{4096} | h5::gzip{6});
+ *   h5::append(pt, record);
+ *   h5::cpt_reader<tick> ticks(fd, "ticks", {"ask_price"}); // other fields are left zero
+ */
+namespace h5 { namespace impl {
+	struct field_t {
+		std::string name;
+		size_t offset, size; // of member in record, size in memory and in dataset
+		h5::dt_t<void*> type;
+	};
+	// members of compound type `T`, as registered
+	template <class T> inline std::vector<field_t> get_fields(){
+		h5::dt_t<T> type;
+		if( H5Tget_class( static_cast<::hid_t>( type ) ) != H5T_COMPOUND )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("columns require a compound type..."));
+		std::vector<field_t> fields;
+		for( int i=0, n = H5Tget_nmembers( static_cast<::hid_t>( type ) ); i<n; i++ ){
+			char* name = H5Tget_member_name( static_cast<::hid_t>( type ), i );
+			field_t field{ name, H5Tget_member_offset( static_cast<::hid_t>( type ), i ), 0,
+				h5::dt_t<void*>{ H5Tget_member_type( static_cast<::hid_t>( type ), i ) } };
+			H5free_memory( name );
+			field.size = H5Tget_size( static_cast<::hid_t>( field.type ) );
+			fields.push_back( std::move( field ) );
+		}
+		return fields;
+	}
+}}
+
+namespace h5 {
+	template <class T>
+	struct cpt_t {
+		template <class... args_t>
+		cpt_t( const h5::fd_t& fd, const std::string& path, args_t&&... args );
+		cpt_t( const cpt_t& ) = delete;
+		cpt_t& operator=( const cpt_t& ) = delete;
+		~cpt_t();
+
+		template <class R> friend void append( h5::cpt_t<R>& pt, const R& ref );
+		template <class R> friend void append( h5::cpt_t<R>& pt, const R* first, size_t count );
+		void flush();
+
+		private:
+		struct column_t {
+			column_t( const h5::ds_t& ds, impl::field_t&& field, size_t batch ) :
+				pt( ds ), field( std::move( field ) ), stage( batch * this->field.size ) {}
+			h5::pt_t pt;
+			impl::field_t field;
+			std::vector<char> stage;
+		};
+		void append( const T& ref );
+		void append( const T* first, size_t count );
+		// passes staged fields to columns
+		void push();
+
+		std::vector<std::unique_ptr<column_t>> columns;
+		size_t batch, k; // records staged at most and currently
+	};
+
+	template <class T>
+	struct cpt_reader {
+		using iterator = impl::reader_iterator<cpt_reader,T>;
+		// reads `fields` only, all of them when empty; dapl is passed to each column, see h5::prefetch
+		cpt_reader( const h5::fd_t& fd, const std::string& path, const std::vector<std::string>& fields = {},
+				const h5::dapl_t& dapl = h5::default_dapl );
+
+		// decodes next chunk of requested columns, returns false past the last one
+		bool next();
+		// records of the current chunk, fields not requested are zero
+		const T* data() const { return records.data(); }
+		size_t size() const { return n; }
+		iterator begin(){ return n || next() ? iterator( this ) : end(); }
+		iterator end(){ return iterator(); }
+
+		private:
+		struct column_t {
+			column_t( const h5::ds_t& ds, impl::field_t&& field ) : reader( ds ), field( std::move( field ) ) {}
+			impl::chunk_reader_t reader;
+			impl::field_t field;
+		};
+		std::vector<std::unique_ptr<column_t>> columns;
+		std::vector<T> records;
+		size_t n;
+	};
+}
+
+template <class T> template <class... args_t> inline
+h5::cpt_t<T>::cpt_t( const h5::fd_t& fd, const std::string& path, args_t&&... args ) : k(0) {
+	h5::dcpl_t default_dcpl{ H5Pcreate(H5P_DATASET_CREATE) };
+	const h5::dcpl_t& dcpl = arg::get(default_dcpl, args...);
+	const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
+	if( H5Pget_layout( static_cast<::hid_t>( dcpl ) ) != H5D_CHUNKED )
+		throw h5::error::io::packet_table::create( H5CPP_ERROR_MSG("columns require chunked layout..."));
+	hsize_t chunk_dims[H5CPP_MAX_RANK];
+	h5::get_chunk_dims( dcpl, chunk_dims );
+	batch = *chunk_dims;
+
+	h5::sp_t space = h5::create_simple( h5::current_dims{0}, h5::max_dims{H5S_UNLIMITED} );
+	for( auto& field : impl::get_fields<T>() ){
+		std::string name = path + "/" + field.name;
+		h5::ds_t ds{H5I_UNINIT};
+		if( H5Lexists( static_cast<::hid_t>( fd ), path.data(), H5P_DEFAULT ) > 0
+				&& H5Lexists( static_cast<::hid_t>( fd ), name.data(), H5P_DEFAULT ) > 0 )
+			ds = h5::open( fd, name, dapl );
+		else
+			ds = h5::createds( fd, name, field.type, space, h5::default_lcpl, dcpl, dapl );
+		columns.emplace_back( new column_t( ds, std::move( field ), batch ) );
+	}
+}
+
+template <class T> inline
+h5::cpt_t<T>::~cpt_t(){
+	try { // columns are flushed when closed
+		push();
+	} catch ( const std::exception& err ){
+		h5::error::io::packet_table::rollback( err.what() );
+	}
+}
+
+template <class T> inline
+void h5::cpt_t<T>::push(){
+	if( k == 0 ) return;
+	for( auto& column : columns )
+		h5::append( column->pt, column->stage.data(), k );
+	k = 0;
+}
+
+template <class T> inline
+void h5::cpt_t<T>::append( const T& ref ){
+	const char* record = reinterpret_cast<const char*>( &ref );
+	for( auto& column : columns )
+		memcpy( column->stage.data() + k * column->field.size, record + column->field.offset, column->field.size );
+	if( ++k == batch ) push();
+}
+
+template <class T> inline
+void h5::cpt_t<T>::append( const T* first, size_t count ){
+	// column by column, a batch at a time
+	for( size_t m; count; count -= m, first += m ){
+		m = std::min( batch - k, count );
+		const char* record = reinterpret_cast<const char*>( first );
+		for( auto& column : columns ){
+			char* stage = column->stage.data() + k * column->field.size;
+			for( size_t i=0; i<m; i++ )
+				memcpy( stage + i * column->field.size, record + i * sizeof(T) + column->field.offset, column->field.size );
+		}
+		if( (k += m) == batch ) push();
+	}
+}
+
+template <class T> inline
+void h5::cpt_t<T>::flush(){
+	push();
+	for( auto& column : columns )
+		column->pt.flush();
+}
+
+template <class T> inline
+h5::cpt_reader<T>::cpt_reader( const h5::fd_t& fd, const std::string& path, const std::vector<std::string>& fields,
+		const h5::dapl_t& dapl ) : n(0) {
+	size_t capacity = 0;
+	for( auto& field : impl::get_fields<T>() ){
+		if( !fields.empty() && std::find( fields.begin(), fields.end(), field.name ) == fields.end() ) continue;
+		std::string name = path + "/" + field.name;
+		columns.emplace_back( new column_t( h5::open( fd, name, dapl ), std::move( field ) ) );
+		if( columns.back()->reader.element_size() != columns.back()->field.size )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("element size of column doesn't match field..."));
+		capacity = std::max( capacity, columns.back()->reader.capacity() );
+	}
+	if( columns.size() < std::max( fields.size(), size_t(1) ) )
+		throw h5::error::io::packet_table::open( H5CPP_ERROR_MSG("no such field..."));
+	records.resize( capacity );
+}
+
+template <class T> inline
+bool h5::cpt_reader<T>::next(){
+	n = 0;
+	for( auto& column : columns ){
+		if( !column->reader.next() ) return n = 0, false;
+		// columns are written together, chunks of the same number of records are expected
+		if( n && column->reader.size() != n )
+			throw h5::error::io::packet_table::read( H5CPP_ERROR_MSG("columns with different chunk size..."));
+		n = column->reader.size();
+		const char* src = column->reader.data();
+		char* dst = reinterpret_cast<char*>( records.data() ) + column->field.offset;
+		for( size_t i=0; i<n; i++ )
+			memcpy( dst + i * sizeof(T), src + i * column->field.size, column->field.size );
+	}
+	return n != 0;
+}
+
+namespace h5 {
+	/** @ingroup io-append
+	 * @brief splits record into fields and appends them to the columns of the table
+	 * @param pt columnar packet table descriptor
+	 * @param ref record to append
+	 * @tparam T compound record type registered with h5::register_struct<T>()
+	 */
+	template <class T> inline void append( h5::cpt_t<T>& pt, const T& ref ){
+		pt.append( ref );
+	}
+	/** @ingroup io-append
+	 * @brief appends `count` contiguous records to the columns of the table
+	 */
+	template <class T> inline void append( h5::cpt_t<T>& pt, const T* first, size_t count ){
+		pt.append( first, count );
+	}
+}
+#endif
@@ -32,30 +32,111 @@ namespace h5{
 		// custom h5cpp specific C++ high throughpout filter
 		// is abstracted out and hidden under property list
 		// see: H5Pdapl.hpp and H5Pchunk.hpp for details
-		hid_t dcpl = H5Dget_create_plist( ds );
-
-		switch( H5Pget_layout(dcpl) ){
-			case H5D_COMPACT: break;
-			case H5D_CONTIGUOUS: break;
-			case H5D_CHUNKED:
-				if( H5Pexist(dapl, H5CPP_DAPL_HIGH_THROUGPUT) ){
-					// grab pointer to uninitialized pipeline
-					h5::impl::pipeline_t<impl::basic_pipeline_t>* ptr;
-					H5Pget(dapl, H5CPP_DAPL_HIGH_THROUGPUT, &ptr);
-					hid_t type_id = H5Dget_type( static_cast<::hid_t>(ds) );
-					size_t element_size = H5Tget_size( type_id );
-					ptr->set_cache(dcpl, element_size);
-				}
-				break;
-			case H5D_VIRTUAL: break;
-		}
-
 		h5::ds_t ds_{ds};
-		//FIXME: temporary carry dapl around
-		ds_.dapl = static_cast<hid_t>( dapl );
+		ds_.dapl = h5::impl::dapl_pipeline_open( ds, static_cast<hid_t>( dapl ) );
 		return ds_;
     }
 }
 
+namespace h5 { namespace impl {
+	/* least recently used datasets opened by path through a file descriptor, keyed by path and the content of dapl:
+	 * a property list made for each call, as with h5::high_throughput, finds the dataset opened with an equal one */
+	struct ds_cache_t {
+		struct entry_t {
+			std::string path;
+			h5::dapl_t dapl; // as passed by caller, ds.dapl is a private copy
+			h5::ds_t ds;
+		};
+		using iterator_t = std::list<entry_t>::iterator;
+
+		ds_cache_t( size_t capacity ) : capacity( capacity ) {}
+		// descriptor opened with `path` and a dapl equal to `dapl` before or nullptr
+		const h5::ds_t* find( const std::string& path, const h5::dapl_t& dapl );
+		// keeps `ds` open, the least recently used one is closed when over capacity
+		const h5::ds_t& insert( const std::string& path, const h5::dapl_t& dapl, const h5::ds_t& ds );
+		size_t size() const { return lru.size(); }
+
+		const size_t capacity;
+		private:
+		iterator_t lookup( const std::string& path, const h5::dapl_t& dapl );
+		void erase( iterator_t it );
+
+		std::list<entry_t> lru; // most recently used first
+		std::unordered_multimap<std::string, iterator_t> index; // entries of a path differ in dapl
+	};
+
+	// descriptor cached with `fd` or nullptr
+	inline const h5::ds_t* find_ds( const h5::fd_t& fd, const std::string& path, const h5::dapl_t& dapl ){
+		return fd.cache ? fd.cache->find( path, dapl ) : nullptr;
+	}
+	// `ds` kept open with `fd` if caching is on, the descriptor to use is returned
+	inline const h5::ds_t& keep_ds( const h5::fd_t& fd, const std::string& path, const h5::dapl_t& dapl, const h5::ds_t& ds ){
+		return fd.cache ? fd.cache->insert( path, dapl, ds ) : ds;
+	}
+	// dataset at `path` opened with `dapl` from the cache of `fd`, or into `ds` when not cached
+	inline const h5::ds_t& open_ds( const h5::fd_t& fd, const std::string& path, const h5::dapl_t& dapl, h5::ds_t& ds ){
+		if( const h5::ds_t* cached = find_ds( fd, path, dapl ) ) return *cached;
+		ds = h5::open( fd, path, dapl );
+		return keep_ds( fd, path, dapl, ds );
+	}
+}}
+
+inline h5::impl::ds_cache_t::iterator_t h5::impl::ds_cache_t::lookup( const std::string& path, const h5::dapl_t& dapl ){
+	auto range = index.equal_range( path );
+	for( auto it = range.first; it != range.second; it++ ){
+		::hid_t cached = static_cast<::hid_t>( it->second->dapl );
+		if( cached == static_cast<::hid_t>( dapl ) || H5Pequal( cached, static_cast<::hid_t>( dapl ) ) > 0 )
+			return it->second;
+	}
+	return lru.end();
+}
+
+inline void h5::impl::ds_cache_t::erase( iterator_t entry ){
+	auto range = index.equal_range( entry->path );
+	for( auto it = range.first; it != range.second; it++ )
+		if( it->second == entry ){
+			index.erase( it );
+			break;
+		}
+	lru.erase( entry );
+}
+
+inline const h5::ds_t* h5::impl::ds_cache_t::find( const std::string& path, const h5::dapl_t& dapl ){
+	iterator_t it = lookup( path, dapl );
+	if( it == lru.end() ) return nullptr;
+	if( it != lru.begin() ) lru.splice( lru.begin(), lru, it );
+	return &it->ds;
+}
+
+inline const h5::ds_t& h5::impl::ds_cache_t::insert( const std::string& path, const h5::dapl_t& dapl, const h5::ds_t& ds ){
+	iterator_t it = lookup( path, dapl );
+	if( it != lru.end() ) erase( it );
+	lru.push_front( entry_t{ path, dapl, ds } );
+	index.emplace( path, lru.begin() );
+	while( lru.size() > capacity )
+		erase( std::prev( lru.end() ) );
+	return lru.front().ds;
+}
+
+namespace h5 {
+	/** \ingroup file-io
+	 * keeps up to `capacity` datasets opened by the path based h5::read and h5::write calls through `fd` -- and copies of
+	 * it made afterwards -- open, closing the least recently used ones first; instead of looking up the path, reading
+	 * the object header and setting up the dapl pipeline on every call. Datasets are keyed by path and the content of
+	 * dapl, compared with H5Pequal: passing a new h5::high_throughput, h5::prefetch{n}, ... list each call hits the
+	 * dataset opened with the same settings. Datasets must not be unlinked or replaced while cached. Descriptor and its
+	 * copies must be used from one thread at a time.
+	 * \par_fd \param capacity maximum number of datasets kept open, 0 closes them and turns caching off
+	 * @code
+	 * h5::fd_t fd = h5::open("example.h5", H5F_ACC_RDWR);
+	 * h5::set_ds_cache(fd, 1024);
+	 * for( auto& path : paths ) h5::read(fd, path, row.data(), h5::count{1,n}, h5::offset{i,0});
+	 * @endcode
+	 */
+	inline void set_ds_cache( h5::fd_t& fd, size_t capacity ){
+		fd.cache = capacity ? std::make_shared<impl::ds_cache_t>( capacity ) : nullptr;
+	}
+}
+
 #endif
 
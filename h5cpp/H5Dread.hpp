@@ -54,22 +54,24 @@ namespace h5 {
 		const h5::dxpl_t& dxpl = arg::get( h5::default_dxpl, args...);
 		H5CPP_CHECK_PROP( dxpl, h5::error::property_list::misc, "invalid data transfer property" );
 
-		h5::sp_t file_space = h5::get_space(ds);
-	   	int rank = h5::get_simple_extent_ndims( file_space );
+		// rank, pipeline and dataspaces are cached with the descriptor, see H5capi.hpp
+		h5::impl::ds_meta_t& meta = h5::impl::get_meta( ds );
 
-		if( rank != count.rank ) throw h5::error::io::dataset::read( H5CPP_ERROR_MSG( h5::error::msg::rank_mismatch ));
+		if( meta.rank != count.rank ) throw h5::error::io::dataset::read( H5CPP_ERROR_MSG( h5::error::msg::rank_mismatch ));
 		using element_t = typename impl::decay<T>::type;
 		h5::dt_t<element_t> mem_type;
 
-		hid_t dapl = h5::get_access_plist( ds );
-		if( H5Pexist(dapl, H5CPP_DAPL_HIGH_THROUGPUT) ){
-			h5::impl::pipeline_t<impl::basic_pipeline_t>* filters;
-			H5Pget(dapl, H5CPP_DAPL_HIGH_THROUGPUT, &filters);
+		if constexpr( std::is_same<std::string,T>::value ){ // variable, fixed length or dictionary, see H5Dstring.hpp
+			size_t n = 1; for(int i=0;i<size.rank;i++) n *= size[i];
+			h5::arena_t arena;
+			std::vector<std::string_view> strings( n );
+			impl::read_views( ds, meta, meta.memory( size ), meta.select( ds, offset, stride, count, block ), dxpl, arena, strings.data(), n );
+			for( size_t i=0; i<n; i++ ) ptr[i].assign( strings[i] );
+		}else if( h5::impl::pipeline_base_t* filters = meta.pipeline ){
 			filters->read(ds, offset, stride, block, count, dxpl, ptr);
 		}else{
-			h5::sp_t mem_space = h5::create_simple( size );
-			h5::select_all( mem_space );
-			h5::select_hyperslab( file_space, offset, stride, count, block);
+			const h5::sp_t& mem_space = meta.memory( size );
+			const h5::sp_t& file_space = meta.select( ds, offset, stride, count, block );
 
 			H5CPP_CHECK_NZ( H5Dread(
 					static_cast<hid_t>( ds ), static_cast<hid_t>(mem_type), static_cast<hid_t>(mem_space),
@@ -98,7 +100,8 @@ namespace h5 {
 	template<class T, class... args_t>
 	void read( const h5::fd_t& fd, const std::string& dataset_path, T* ptr, args_t&&... args ){
 		const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
-		h5::ds_t ds = h5::open(fd, dataset_path, dapl ); // will throw its exception
+		h5::ds_t ds_; // kept open with fd when cached, see h5::set_ds_cache
+		const h5::ds_t& ds = h5::impl::open_ds(fd, dataset_path, dapl, ds_ ); // will throw its exception
 		h5::read<T>(ds, ptr, args...);
 	}
 
@@ -163,7 +166,8 @@ namespace h5 {
 		void read( const h5::fd_t& fd,  const std::string& dataset_path, T& ref, args_t&&... args ){
 
 		const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
-		h5::ds_t ds = h5::open(fd, dataset_path, dapl );
+		h5::ds_t ds_;
+		const h5::ds_t& ds = h5::impl::open_ds(fd, dataset_path, dapl, ds_ );
 		h5::read<T>(ds, ref, args...);
 	}
 
@@ -184,6 +188,68 @@ namespace h5 {
 		h5::read( fd, dataset_path, ref, args...);
 	}
 
+/***************************  STRINGS *****************************/
+ 	/** \func_read_hdr
+ 	*  Reads variable length, fixed length or dictionary encoded strings into **arena** -- a single block once warm, instead of a heap allocation per string --
+	*  and returns views of them, valid until the arena is cleared or destroyed; strings of consecutive calls are appended.
+	*  Optional arguments **args:= h5::offset | h5::stride | h5::count | h5::block** may be specified for partial IO,
+	*  to describe the retrieved hyperslab from hdf5 file space. Default case is to select and retrieve all elements from dataset. 
+	* \code
+	* h5::arena_t arena;
+	* std::vector<std::string_view> symbols = h5::read( ds, arena, h5::count{1000}, h5::offset{5000} );
+	* ...
+	* arena.clear();
+	* \endcode  
+	* \par_ds \par_offset \par_stride \par_count \par_block \par_dxpl \returns_object
+ 	*/
+	template<class... args_t>
+	std::vector<std::string_view> read( const h5::ds_t& ds, h5::arena_t& arena, args_t&&... args ) try {
+		using tcount  = typename arg::tpos<const h5::count_t&,const args_t&...>;
+
+		h5::count_t default_count;
+		if constexpr( !tcount::present ){ // read count ::= current_dim of file space 
+			h5::sp_t file_space = h5::get_space( ds );
+			h5::get_simple_extent_dims( file_space, default_count );
+		}
+		const h5::count_t& count = arg::get( default_count, args...);
+		h5::offset_t  default_offset{0,0,0,0,0,0};
+		const h5::offset_t& offset = arg::get( default_offset, args...);
+		h5::stride_t  default_stride{1,1,1,1,1,1,1};
+		const h5::stride_t& stride = arg::get( default_stride, args...);
+		h5::block_t  default_block{1,1,1,1,1,1,1};
+		const h5::block_t& block = arg::get( default_block, args...);
+		const h5::dxpl_t& dxpl = arg::get( h5::default_dxpl, args...);
+		H5CPP_CHECK_PROP( dxpl, h5::error::property_list::misc, "invalid data transfer property" );
+
+		h5::impl::ds_meta_t& meta = h5::impl::get_meta( ds );
+		if( meta.rank != count.rank ) throw h5::error::io::dataset::read( H5CPP_ERROR_MSG( h5::error::msg::rank_mismatch ));
+		h5::count_t size; // compute actual memory space
+		size_t n = 1;
+		for(int i=0;i<count.rank;i++) n *= size[i] = count[i] * block[i];
+		size.rank = count.rank;
+
+		std::vector<std::string_view> strings( n );
+		impl::read_views( ds, meta, meta.memory( size ), meta.select( ds, offset, stride, count, block ), dxpl, arena, strings.data(), n );
+		return strings;
+	} catch ( const std::runtime_error& err ){
+		throw h5::error::io::dataset::read( err.what() );
+	}
+ 	/** \func_read_hdr
+ 	*  Reads strings of dataset at **dataset_path** into **arena**, see h5::read( ds, arena, ... ) 
+	* \code
+	* h5::arena_t arena;
+	* auto symbols = h5::read( fd, "symbols", arena );
+	* \endcode  
+	* \par_fd \par_dataset_path \par_offset \par_stride \par_count \par_block \par_dxpl \returns_object
+ 	*/
+	template<class... args_t>
+	std::vector<std::string_view> read( const h5::fd_t& fd, const std::string& dataset_path, h5::arena_t& arena, args_t&&... args ){
+		const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
+		h5::ds_t ds_;
+		const h5::ds_t& ds = h5::impl::open_ds(fd, dataset_path, dapl, ds_ );
+		return h5::read( ds, arena, args...);
+	}
+
 /***************************  OBJECT *****************************/
  	/** \func_read_hdr
  	*  Direct read from an opened dataset descriptor that returns the entire data space wrapped into the object specified. 
@@ -234,10 +300,11 @@ namespace h5 {
 	* \par_fd \par_dataset_path \par_offset \par_stride \par_count \par_block \tpar_T \returns_object 
  	*/
 	template<class T, class... args_t> // dispatch to above
-	T read( hid_t fd, const std::string& dataset_path, args_t&&... args ){
+	T read( const h5::fd_t& fd, const std::string& dataset_path, args_t&&... args ){
 
 		const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
-		h5::ds_t ds = h5::open(fd, dataset_path, dapl );
+		h5::ds_t ds_;
+		const h5::ds_t& ds = h5::impl::open_ds(fd, dataset_path, dapl, ds_ );
 		return h5::read<T>(ds, args...);
 	}
  	/** \func_read_hdr
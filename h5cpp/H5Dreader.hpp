@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#ifndef  H5CPP_DREADER_HPP
+#define H5CPP_DREADER_HPP
+
+/* read side of h5::pt_t: scans a packet table one chunk at a time with direct chunk IO into a single buffer,
+ * memory use is that of a chunk regardless of the size of the dataset. With h5::prefetch{n} on the dapl the
+ * next `n` chunks are decoded on a background thread while the current one is processed.
+ * Records are copied bitwise, `T` must be the in memory layout of the element type of the dataset.
+ *   h5::pt_reader<tick> ticks = h5::open(fd, "ticks", h5::prefetch{2});
+ *   for( const auto& tick : ticks ) ...;
+ * h5::pt_tail follows a packet table written in SWMR mode by another process, see h5::swmr_flush:
+ *   h5::fd_t fd = h5::open("ticks.h5", H5F_ACC_RDONLY | H5F_ACC_SWMR_READ);
+ *   h5::pt_tail<tick> ticks = h5::open(fd, "ticks");
+ *   for( std::vector<tick> batch;; batch.clear() ) if( ticks.poll( batch ) ) ...;
+ */
+namespace h5 { namespace impl {
+	// untyped chunk at a time scan of dataset, chunks must span all but the first dimension
+	struct chunk_reader_t {
+		chunk_reader_t( const h5::ds_t& handle );
+		chunk_reader_t( const chunk_reader_t& ) = delete;
+		chunk_reader_t& operator=( const chunk_reader_t& ) = delete;
+
+		// decodes next chunk into buffer, returns false past the last one
+		bool next();
+		// next chunk to decode is `chunk` along the first dimension
+		void seek( hsize_t chunk ){ *offset = chunk * *chunk_dims, n = 0; }
+		// scan, read ahead included, ends before `chunk` along the first dimension
+		void until( hsize_t chunk ){ stop = chunk * *chunk_dims; }
+		// picks up the extent of dataset written by another process in SWMR mode
+		void refresh();
+		// false for chunks within the extent not written yet
+		bool allocated( hsize_t chunk ) const;
+		// elements of the current chunk
+		const char* data() const { return ptr.get(); }
+		size_t size() const { return n; }
+		// elements of dataset as of opening or the last `refresh`
+		hsize_t records() const { return *current_dims * r; }
+		// elements of a whole chunk
+		size_t capacity() const { return *chunk_dims * r; }
+		size_t element_size() const { return pipeline.element_size; }
+
+		private:
+		impl::basic_pipeline_t pipeline;
+		h5::ds_t ds;
+		h5::dxpl_t dxpl;
+		hsize_t offset[H5CPP_MAX_RANK], // of the next chunk
+			current_dims[H5CPP_MAX_RANK],
+			chunk_dims[H5CPP_MAX_RANK],
+			stop; // along the first dimension, see `until`
+		size_t rank, r, n; // r: elements in a row of chunk, n: elements in current chunk
+		h5::impl::unique_ptr<char> ptr;
+	};
+
+	// single pass input iterator over the records of the remaining chunks of reader `R`
+	template <class R, class T>
+	struct reader_iterator {
+		using iterator_category = std::input_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		reader_iterator( R* reader = nullptr ) : reader( reader ), i(0) {}
+		reference operator*() const { return reader->data()[i]; }
+		pointer operator->() const { return reader->data() + i; }
+		reader_iterator& operator++(){
+			if( ++i == reader->size() ){
+				i = 0;
+				if( !reader->next() ) reader = nullptr;
+			}
+			return *this;
+		}
+		void operator++(int){ ++*this; }
+		bool operator==( const reader_iterator& other ) const { return reader == other.reader && i == other.i; }
+		bool operator!=( const reader_iterator& other ) const { return !(*this == other); }
+		private:
+		R* reader;
+		size_t i;
+	};
+}}
+
+namespace h5 {
+	template <class T>
+	struct pt_reader : private impl::chunk_reader_t {
+		using iterator = impl::reader_iterator<pt_reader,T>;
+
+		pt_reader( const h5::ds_t& handle ); // conversion ctor
+
+		using impl::chunk_reader_t::next;
+		using impl::chunk_reader_t::seek;
+		using impl::chunk_reader_t::until;
+		using impl::chunk_reader_t::size;
+		using impl::chunk_reader_t::records;
+		// records of the current chunk
+		const T* data() const { return reinterpret_cast<const T*>( impl::chunk_reader_t::data() ); }
+		// iterating starts with the current chunk, the first one is loaded on demand
+		iterator begin(){ return size() || next() ? iterator( this ) : end(); }
+		iterator end(){ return iterator(); }
+	};
+
+	template <class T>
+	struct pt_tail : private impl::chunk_reader_t {
+		pt_tail( const h5::ds_t& handle ); // conversion ctor, starts with the first record
+
+		// refreshes dataset and appends records written since the last call to `records`, returns their count;
+		// the trailing partial chunk is read again once more of it is flushed
+		size_t poll( std::vector<T>& records );
+		// records returned so far
+		hsize_t position() const { return at; }
+		// continues with records appended from now on
+		void skip(){ refresh(); at = impl::chunk_reader_t::records(); }
+
+		private:
+		hsize_t at;
+	};
+}
+
+inline
+h5::impl::chunk_reader_t::chunk_reader_t( const h5::ds_t& handle ) :
+	dxpl{H5Pcreate(H5P_DATASET_XFER)}, stop( std::numeric_limits<hsize_t>::max() ), r(1), n(0) {
+	try {
+		ds = handle;
+		h5::sp_t file_space = h5::get_space( handle );
+		rank = h5::get_simple_extent_dims( file_space, current_dims, nullptr );
+		h5::dcpl_t dcpl = h5::get_dcpl( ds );
+		h5::dt_t<void*> type = h5::get_type<void*>( ds );
+		pipeline.set_cache(dcpl, h5::get_size( type ) );
+		h5::get_chunk_dims( dcpl, chunk_dims );
+		for(int i=1; i<rank; i++){ // chunks must hold whole rows, as written by h5::pt_t
+			if( current_dims[i] != chunk_dims[i] )
+				throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("chunk doesn't span dataset in all but the first dimension..."));
+			r *= chunk_dims[i];
+		}
+		pipeline.ds = static_cast<::hid_t>( ds ); pipeline.dxpl = static_cast<::hid_t>( dxpl );
+		if( impl::pipeline_base_t* from = impl::get_pipeline( handle.dapl ) )
+			pipeline.ahead.depth = from->ahead.depth;
+		ptr = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, pipeline.buffer_size )};
+		if( !ptr )
+			throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+		for( int i=0; i<H5CPP_MAX_RANK; i++ ) offset[i] = 0;
+	} catch ( const h5::error::io::packet_table::any& err ){
+		throw;
+	} catch ( ... ){
+		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("CTOR: unable to create handle from dataset..."));
+	}
+}
+
+inline
+bool h5::impl::chunk_reader_t::next(){
+	hsize_t end[H5CPP_MAX_RANK];
+	std::copy( current_dims, current_dims + rank, end );
+	*end = std::min( *end, stop );
+	if( *offset >= *end ) return n = 0, false;
+	// chunks are requested in order: read ahead picks up the sequence after the first few
+	pipeline.ahead.extent( static_cast<::hid_t>( ds ), end );
+	try {
+		pipeline.read_through( offset, ptr.get() );
+	} catch ( const std::runtime_error& err ){
+		throw h5::error::io::packet_table::read( err.what() );
+	}
+	n = std::min( *chunk_dims, *current_dims - *offset ) * r;
+	*offset += *chunk_dims;
+	return true;
+}
+
+inline
+void h5::impl::chunk_reader_t::refresh(){
+	H5CPP_CHECK_NZ( H5Drefresh( static_cast<::hid_t>( ds ) ), h5::error::io::packet_table::read, "couldn't refresh dataset...");
+	h5::sp_t file_space = h5::get_space( ds );
+	h5::get_simple_extent_dims( file_space, current_dims, nullptr );
+}
+
+inline
+bool h5::impl::chunk_reader_t::allocated( hsize_t chunk ) const {
+	hsize_t at[H5CPP_MAX_RANK] = {chunk * *chunk_dims};
+	return impl::basic_pipeline_t::stored_size( static_cast<::hid_t>( ds ), at ) != 0;
+}
+
+namespace h5 {
+	/** @ingroup io-read
+	 * @brief records of packet table at `path` with `key` in [lo,hi): chunks overlapping the range are found by binary
+	 * search of the key index, see h5::key_index, then read with direct chunk IO
+	 * @param fd file descriptor
+	 * @param path of packet table with key index, records must be appended in key order
+	 * @param key member of `T` the table is indexed by
+	 * @param dapl data access property list, h5::prefetch reads ahead within the range
+	 * @tparam T element type of packet table
+	 */
+	template <class T, class K>
+	std::vector<T> read_range( const h5::fd_t& fd, const std::string& path, K T::* key,
+			const typename std::decay<K>::type& lo, const typename std::decay<K>::type& hi,
+			const h5::dapl_t& dapl = h5::default_dapl ){
+		h5::ds_t ds = h5::open( fd, path, dapl );
+		h5::ds_t index = h5::open( fd, impl::index_path( static_cast<::hid_t>( ds ) ) );
+		hsize_t dims[2];
+		h5::sp_t space = h5::get_space( index );
+		h5::get_simple_extent_dims( space, dims, nullptr );
+		using key_t = typename std::decay<K>::type;
+		std::vector<key_t> rows( 2 * *dims ); // converted to `K` by HDF5 when stored otherwise
+		h5::dt_t<key_t> type;
+		if( *dims ) H5CPP_CHECK_NZ( H5Dread( static_cast<::hid_t>( index ), static_cast<::hid_t>( type ), H5S_ALL, H5S_ALL,
+					H5P_DEFAULT, rows.data() ), h5::error::io::packet_table::read, "couldn't read key index...");
+		// keys are non decreasing: first chunk reaching `lo` and the first one starting at `hi` or above
+		hsize_t first = 0, last;
+		for( hsize_t count = *dims; count; ){ // lower bound on highest keys
+			hsize_t step = count / 2;
+			if( rows[2*(first + step) + 1] < lo ) first += step + 1, count -= step + 1; else count = step;
+		}
+		last = first;
+		for( hsize_t count = *dims - first; count; ){ // lower bound on lowest keys
+			hsize_t step = count / 2;
+			if( rows[2*(last + step)] < hi ) last += step + 1, count -= step + 1; else count = step;
+		}
+		std::vector<T> records;
+		if( first >= last ) return records;
+		pt_reader<T> reader( ds );
+		size_t offset = impl::offset_of( key );
+		reader.seek( first );
+		reader.until( last ); // no chunks past the range are read ahead
+		while( reader.next() )
+			for( size_t i=0; i<reader.size(); i++ ){
+				key_t k = impl::key_of<key_t>( reinterpret_cast<const char*>( reader.data() + i ) + offset );
+				if( k >= lo && k < hi ) records.push_back( reader.data()[i] );
+			}
+		return records;
+	}
+}
+
+template <class T> inline
+h5::pt_reader<T>::pt_reader( const h5::ds_t& handle ) : impl::chunk_reader_t( handle ) {
+	if( element_size() != sizeof(T) )
+		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("element size of dataset doesn't match record..."));
+}
+
+template <class T> inline
+h5::pt_tail<T>::pt_tail( const h5::ds_t& handle ) : impl::chunk_reader_t( handle ), at(0) {
+	if( element_size() != sizeof(T) )
+		throw h5::error::io::packet_table::misc( H5CPP_ERROR_MSG("element size of dataset doesn't match record..."));
+}
+
+template <class T> inline
+size_t h5::pt_tail<T>::poll( std::vector<T>& records ){
+	refresh();
+	size_t count = records.size();
+	for( hsize_t chunk; at < impl::chunk_reader_t::records(); ){
+		chunk = at / capacity();
+		// extent of a new chunk is flushed before the chunk itself
+		if( !allocated( chunk ) ) break;
+		seek( chunk );
+		next();
+		const T* first = reinterpret_cast<const T*>( data() );
+		records.insert( records.end(), first + at % capacity(), first + size() );
+		at = chunk * capacity() + size();
+	}
+	return records.size() - count;
+}
+#endif
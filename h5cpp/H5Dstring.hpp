@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#ifndef  H5CPP_DSTRING_HPP
+#define H5CPP_DSTRING_HPP
+
+#define H5CPP_DICTIONARY_ATTRIBUTE "dictionary"
+
+/* std::string elements are stored as variable length strings by default, each in the global heap. Datasets created
+ * by h5::write with one of the tags below store them instead as
+ *   h5::fixed_length{n}: strings padded to `n` bytes -- the longest one when 0 -- chunked and compressed as any other
+ *   h5::dictionary:      unsigned codes at the path of the dataset, and the unique strings in `<path>.dictionary`,
+ *                        named by the `dictionary` attribute of the codes
+ * reads and writes of std::string find out the storage from the type and attributes of the dataset:
+ *   h5::write(fd, "symbols", symbols, h5::dictionary, h5::chunk{4096} | h5::gzip{9});
+ *   auto symbols = h5::read<std::vector<std::string>>(fd, "symbols");
+ */
+namespace h5 {
+	struct fixed_length_t { size_t width; };
+	struct dictionary_t {};
+	using fixed_length = fixed_length_t;
+	const static dictionary_t dictionary;
+}
+
+namespace h5 { namespace impl {
+	inline void* arena_alloc( size_t size, void* arena ){
+		return static_cast<h5::arena_t*>( arena )->allocate( size );
+	}
+	inline void arena_free( void* ptr, void* arena ){} // released with arena
+
+	// `n` variable length strings of selection read into `arena` instead of a heap allocation each
+	inline void read_vl( const h5::ds_t& ds, const h5::sp_t& mem_space, const h5::sp_t& file_space,
+			const h5::dxpl_t& dxpl, h5::arena_t& arena, std::string_view* ptr, size_t n ){
+		::hid_t id = static_cast<::hid_t>( dxpl );
+		h5::dxpl_t vl{ id == H5P_DEFAULT ? H5Pcreate( H5P_DATASET_XFER ) : H5Pcopy( id ) };
+		H5CPP_CHECK_NZ( H5Pset_vlen_mem_manager( static_cast<::hid_t>( vl ), arena_alloc, &arena, arena_free, nullptr ),
+				std::runtime_error, "couldn't set memory manager for variable length data..." );
+		std::vector<char*> strings( n );
+		h5::dt_t<char*> mem_type;
+		H5CPP_CHECK_NZ( H5Dread( static_cast<::hid_t>( ds ), static_cast<::hid_t>( mem_type ), static_cast<::hid_t>( mem_space ),
+					static_cast<::hid_t>( file_space ), static_cast<::hid_t>( vl ), strings.data() ),
+				std::runtime_error, h5::error::msg::read_dataset );
+		for( size_t i=0; i<n; i++ )
+			ptr[i] = strings[i] ? std::string_view( strings[i] ) : std::string_view();
+	}
+
+	/* unique strings of a dictionary encoded dataset, the code of a string is its position: loaded once per descriptor
+	 * of the codes, see ds_meta_t, then only entries appended since -- through any descriptor -- are read on each call */
+	struct dictionary_t {
+		// strings of dataset at `path` in the file of `ds`
+		dictionary_t( const h5::ds_t& ds, const std::string& path );
+		// entries appended to dataset are read, all of them when it was rewritten
+		void sync();
+		// code of `word`, added when not found
+		unsigned encode( const std::string& word );
+		// added entries are appended to dataset
+		void flush();
+
+		std::vector<std::string_view> words; // into arena
+		private:
+		h5::ds_t ds;
+		h5::arena_t arena;
+		size_t stored;
+		std::unordered_map<std::string_view, unsigned> codes;
+	};
+
+	// path of dictionary named by attribute of `ds`, empty when `ds` isn't dictionary encoded
+	inline std::string get_dictionary_path( ::hid_t ds ){
+		if( H5Aexists( ds, H5CPP_DICTIONARY_ATTRIBUTE ) <= 0 ) return std::string();
+		h5::at_t attr{ H5Aopen( ds, H5CPP_DICTIONARY_ATTRIBUTE, H5P_DEFAULT ) };
+		h5::dt_t<char*> type;
+		char* path = nullptr;
+		H5CPP_CHECK_NZ( H5Aread( static_cast<::hid_t>( attr ), static_cast<::hid_t>( type ), &path ),
+				std::runtime_error, "couldn't read dictionary attribute..." );
+		std::string value( path ? path : "" );
+		H5free_memory( path );
+		return value;
+	}
+	inline void set_dictionary_path( ::hid_t ds, const std::string& path ){
+		h5::sp_t space{ H5Screate( H5S_SCALAR ) };
+		h5::dt_t<char*> type;
+		h5::at_t attr{ H5Acreate2( ds, H5CPP_DICTIONARY_ATTRIBUTE, static_cast<::hid_t>( type ), static_cast<::hid_t>( space ),
+				H5P_DEFAULT, H5P_DEFAULT ) };
+		const char* value = path.c_str();
+		H5CPP_CHECK_NZ( H5Awrite( static_cast<::hid_t>( attr ), static_cast<::hid_t>( type ), &value ),
+				std::runtime_error, "couldn't write dictionary attribute..." );
+	}
+	// dictionary of `ds` kept with its descriptor, and up to date
+	inline dictionary_t& load_dictionary( const h5::ds_t& ds, impl::ds_meta_t& meta ){
+		if( !meta.dictionary ){
+			std::string path = get_dictionary_path( static_cast<::hid_t>( ds ) );
+			if( path.empty() )
+				throw std::runtime_error( H5CPP_ERROR_MSG("dataset doesn't hold strings...") );
+			meta.dictionary = std::make_shared<dictionary_t>( ds, path );
+		}
+		meta.dictionary->sync();
+		return *meta.dictionary;
+	}
+
+	// default path of dictionary of `ds` created by h5::write
+	inline std::string dictionary_path( ::hid_t ds ){
+		ssize_t length = H5Iget_name( ds, nullptr, 0 );
+		if( length <= 0 )
+			throw std::runtime_error( H5CPP_ERROR_MSG("couldn't get name of dataset...") );
+		std::string path( length, '\0' );
+		H5Iget_name( ds, &path[0], length + 1 );
+		return path + ".dictionary";
+	}
+
+	/* `n` strings of selection read as views into `arena`: variable and fixed length ones are copied, dictionary
+	 * encoded ones are views of the dictionary */
+	inline void read_views( const h5::ds_t& ds, impl::ds_meta_t& meta, const h5::sp_t& mem_space, const h5::sp_t& file_space,
+			const h5::dxpl_t& dxpl, h5::arena_t& arena, std::string_view* ptr, size_t n ){
+		::hid_t type = static_cast<::hid_t>( meta.type( ds ) );
+		switch( H5Tget_class( type ) ){
+			case H5T_STRING:
+				if( H5Tis_variable_str( type ) > 0 )
+					read_vl( ds, mem_space, file_space, dxpl, arena, ptr, n );
+				else {
+					size_t width = H5Tget_size( type );
+					char* buffer = static_cast<char*>( arena.allocate( n * width ) );
+					if( !buffer ) throw std::runtime_error( H5CPP_ERROR_MSG( h5::error::msg::mem_alloc ) );
+					H5CPP_CHECK_NZ( H5Dread( static_cast<::hid_t>( ds ), type, static_cast<::hid_t>( mem_space ),
+								static_cast<::hid_t>( file_space ), static_cast<::hid_t>( dxpl ), buffer ),
+							std::runtime_error, h5::error::msg::read_dataset );
+					for( size_t i=0; i<n; i++, buffer += width )
+						ptr[i] = std::string_view( buffer, strnlen( buffer, width ) );
+				}
+				break;
+			case H5T_INTEGER: {
+				dictionary_t& dictionary = load_dictionary( ds, meta );
+				std::vector<unsigned> codes( n );
+				H5CPP_CHECK_NZ( H5Dread( static_cast<::hid_t>( ds ), H5T_NATIVE_UINT, static_cast<::hid_t>( mem_space ),
+							static_cast<::hid_t>( file_space ), static_cast<::hid_t>( dxpl ), codes.data() ),
+						std::runtime_error, h5::error::msg::read_dataset );
+				// entries are copied into `arena` once per read: views outlive the descriptor
+				std::unordered_map<unsigned, std::string_view> copies;
+				for( size_t i=0; i<n; i++ ){
+					if( codes[i] >= dictionary.words.size() )
+						throw std::runtime_error( H5CPP_ERROR_MSG("code not found in dictionary...") );
+					auto it = copies.find( codes[i] );
+					if( it == copies.end() ){
+						std::string_view word = dictionary.words[ codes[i] ];
+						char* copy = static_cast<char*>( arena.allocate( word.size() + 1 ) );
+						if( !copy ) throw std::runtime_error( H5CPP_ERROR_MSG( h5::error::msg::mem_alloc ) );
+						memcpy( copy, word.data(), word.size() ); copy[ word.size() ] = '\0';
+						it = copies.emplace( codes[i], std::string_view( copy, word.size() ) ).first;
+					}
+					ptr[i] = it->second;
+				}
+				break;
+			}
+			default:
+				throw std::runtime_error( H5CPP_ERROR_MSG("dataset doesn't hold strings...") );
+		}
+	}
+
+	// `n` strings of selection written as stored by dataset
+	inline void write_strings( const h5::ds_t& ds, impl::ds_meta_t& meta, const h5::sp_t& mem_space, const h5::sp_t& file_space,
+			const h5::dxpl_t& dxpl, const std::string* ptr, size_t n ){
+		::hid_t type = static_cast<::hid_t>( meta.type( ds ) );
+		switch( H5Tget_class( type ) ){
+			case H5T_STRING:
+				if( H5Tis_variable_str( type ) > 0 ){ // HDF5 copies the strings, buffers are passed as they are
+					std::vector<const char*> strings( n );
+					for( size_t i=0; i<n; i++ ) strings[i] = ptr[i].c_str();
+					h5::dt_t<char*> mem_type;
+					H5CPP_CHECK_NZ( H5Dwrite( static_cast<::hid_t>( ds ), static_cast<::hid_t>( mem_type ), static_cast<::hid_t>( mem_space ),
+								static_cast<::hid_t>( file_space ), static_cast<::hid_t>( dxpl ), strings.data() ),
+							std::runtime_error, h5::error::msg::write_dataset );
+				} else {
+					size_t width = H5Tget_size( type );
+					std::vector<char> buffer( n * width, 0 );
+					for( size_t i=0; i<n; i++ ){
+						if( ptr[i].size() > width )
+							throw std::runtime_error( H5CPP_ERROR_MSG("string is longer than fixed length of dataset...") );
+						memcpy( buffer.data() + i * width, ptr[i].data(), ptr[i].size() );
+					}
+					H5CPP_CHECK_NZ( H5Dwrite( static_cast<::hid_t>( ds ), type, static_cast<::hid_t>( mem_space ),
+								static_cast<::hid_t>( file_space ), static_cast<::hid_t>( dxpl ), buffer.data() ),
+							std::runtime_error, h5::error::msg::write_dataset );
+				}
+				break;
+			case H5T_INTEGER: {
+				dictionary_t& dictionary = load_dictionary( ds, meta );
+				std::vector<unsigned> codes( n );
+				for( size_t i=0; i<n; i++ ) codes[i] = dictionary.encode( ptr[i] );
+				dictionary.flush();
+				H5CPP_CHECK_NZ( H5Dwrite( static_cast<::hid_t>( ds ), H5T_NATIVE_UINT, static_cast<::hid_t>( mem_space ),
+							static_cast<::hid_t>( file_space ), static_cast<::hid_t>( dxpl ), codes.data() ),
+						std::runtime_error, h5::error::msg::write_dataset );
+				break;
+			}
+			default:
+				throw std::runtime_error( H5CPP_ERROR_MSG("dataset doesn't hold strings...") );
+		}
+	}
+
+	/* dataset of `T` for h5::write at `path`, strings are stored as the tags in `args` ask for: `ptr` and `count`
+	 * describe the strings written, the longest one sets the width of h5::fixed_length{0} */
+	template <class T, class... args_t>
+	h5::ds_t create( const h5::fd_t& fd, const std::string& path, const void* ptr, const h5::count_t& count, args_t&&... args ){
+		using tfixed 		= typename arg::tpos<const h5::fixed_length_t&,const args_t&...>;
+		using tdictionary 	= typename arg::tpos<const h5::dictionary_t&,const args_t&...>;
+		using tmax_dims 	= typename arg::tpos<const h5::max_dims_t&,const args_t&...>;
+		using tdcpl 		= typename arg::tpos<const h5::dcpl_t&,const args_t&...>;
+
+		if constexpr( !std::is_same<std::string,T>::value || !(tfixed::present || tdictionary::present) ){
+			return h5::create<T>( fd, path, args... );
+		} else if constexpr( tdictionary::present ){
+			h5::ds_t ds = h5::create<unsigned>( fd, path, args... );
+			std::string words = dictionary_path( static_cast<::hid_t>( ds ) );
+			h5::create<char*>( fd, words, h5::max_dims{H5S_UNLIMITED}, h5::chunk{1024} );
+			set_dictionary_path( static_cast<::hid_t>( ds ), words );
+			return ds;
+		} else try {
+			size_t width = std::get<tfixed::value>( std::forward_as_tuple( args... ) ).width;
+			if( !width ){ // longest, at least one byte
+				size_t n = 1; for(int i=0;i<count.rank;i++) n *= count[i];
+				for( size_t i=0; i<n; i++ )
+					width = std::max( width, static_cast<const std::string*>( ptr )[i].size() );
+				width = std::max<size_t>( width, 1 );
+			}
+
+			h5::dcpl_t default_dcpl{ H5Pcreate(H5P_DATASET_CREATE) };
+			h5::current_dims_t default_current_dims{0};
+			h5::max_dims_t default_max_dims{0};
+			const h5::lcpl_t& lcpl = arg::get(h5::default_lcpl, args...);
+			const h5::dcpl_t& dcpl = arg::get(default_dcpl, args...);
+			const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
+			const h5::current_dims_t& current_dims = arg::get(default_current_dims, args...);
+			const h5::max_dims_t& max_dims = arg::get(default_max_dims, args...);
+
+			if constexpr( !tdcpl::present && tmax_dims::present ){ // extendable, chunked as h5::create does
+				h5::chunk_t chunk{0}; chunk.rank = current_dims.rank;
+				for(int i=0; i<current_dims.rank; i++)
+					chunk[i] = current_dims[i] ? current_dims[i] : 1;
+				h5::set_chunk( default_dcpl, chunk );
+			}
+			h5::sp_t space = tmax_dims::present ? h5::create_simple( current_dims, max_dims ) : h5::create_simple( current_dims );
+			h5::dt_t<char*> type{ H5Tcopy( H5T_C_S1 ) };
+			H5CPP_CHECK_NZ( H5Tset_size( static_cast<::hid_t>( type ), width ), std::runtime_error, "couldn't set length of string..." );
+			H5Tset_strpad( static_cast<::hid_t>( type ), H5T_STR_NULLPAD );
+			return h5::createds( fd, path, type, space, lcpl, dcpl, dapl );
+		} catch( const std::runtime_error& err ) {
+			throw h5::error::io::dataset::create( err.what() );
+		}
+	}
+}}
+
+inline h5::impl::dictionary_t::dictionary_t( const h5::ds_t& codes, const std::string& path ) : stored( 0 ) {
+	h5::fd_t fd{ H5Iget_file_id( static_cast<::hid_t>( codes ) ) };
+	if( H5Lexists( static_cast<::hid_t>( fd ), path.data(), H5P_DEFAULT ) <= 0 )
+		throw std::runtime_error( H5CPP_ERROR_MSG("dictionary of strings not found...") );
+	ds = h5::open( fd, path );
+}
+
+inline void h5::impl::dictionary_t::sync(){
+	for( size_t i=stored; i<words.size(); i++ ) codes.erase( words[i] ); // not flushed by a failed write
+	words.resize( stored );
+	h5::sp_t file_space = h5::get_space( ds );
+	size_t size = H5Sget_simple_extent_npoints( static_cast<::hid_t>( file_space ) );
+	if( size < stored ) // rewritten
+		words.clear(), codes.clear(), arena.clear(), stored = 0;
+	if( size == stored ) return;
+	hsize_t offset = stored, count = size - stored;
+	H5CPP_CHECK_NZ( H5Sselect_hyperslab( static_cast<::hid_t>( file_space ), H5S_SELECT_SET, &offset, nullptr, &count, nullptr ),
+			std::runtime_error, h5::error::msg::select_hyperslab );
+	h5::sp_t mem_space = h5::create_simple( count );
+	words.resize( size );
+	read_vl( ds, mem_space, file_space, h5::default_dxpl, arena, words.data() + stored, count );
+	if( !codes.empty() )
+		for( size_t i=stored; i<size; i++ ) codes.emplace( words[i], i );
+	stored = size;
+}
+
+inline unsigned h5::impl::dictionary_t::encode( const std::string& word ){
+	if( codes.empty() ) // index built on first use, reads don't need it
+		for( size_t i=0; i<words.size(); i++ ) codes.emplace( words[i], i );
+	auto it = codes.find( word );
+	if( it != codes.end() ) return it->second;
+	char* copy = static_cast<char*>( arena.allocate( word.size() + 1 ) );
+	if( !copy ) throw std::runtime_error( H5CPP_ERROR_MSG( h5::error::msg::mem_alloc ) );
+	memcpy( copy, word.c_str(), word.size() + 1 ); // null terminated for flush()
+	words.emplace_back( copy, word.size() );
+	codes.emplace( words.back(), words.size() - 1 );
+	return words.size() - 1;
+}
+
+inline void h5::impl::dictionary_t::flush(){
+	if( words.size() == stored ) return;
+	hsize_t offset = stored, count = words.size() - stored, size = words.size();
+	h5::set_extent( ds, &size );
+	h5::sp_t file_space = h5::get_space( ds );
+	H5CPP_CHECK_NZ( H5Sselect_hyperslab( static_cast<::hid_t>( file_space ), H5S_SELECT_SET, &offset, nullptr, &count, nullptr ),
+			std::runtime_error, h5::error::msg::select_hyperslab );
+	h5::sp_t mem_space = h5::create_simple( count );
+	std::vector<const char*> strings( count );
+	for( size_t i=0; i<count; i++ ) strings[i] = words[stored + i].data();
+	h5::dt_t<char*> type;
+	H5CPP_CHECK_NZ( H5Dwrite( static_cast<::hid_t>( ds ), static_cast<::hid_t>( type ), static_cast<::hid_t>( mem_space ),
+				static_cast<::hid_t>( file_space ), H5P_DEFAULT, strings.data() ), std::runtime_error, h5::error::msg::write_dataset );
+	stored = words.size();
+}
+#endif
@@ -35,9 +35,8 @@ namespace h5 {
 		auto tuple = std::forward_as_tuple(args...);
 		const h5::count_t& count = std::get<tcount::value>( tuple );
 		const h5::dxpl_t& dxpl = arg::get(h5::default_dxpl, args...);
-		h5::sp_t file_space{H5Dget_space( static_cast<::hid_t>(ds) )};
-
-		int rank = h5::get_simple_extent_ndims( file_space );
+		h5::impl::ds_meta_t& meta = h5::impl::get_meta( ds );
+		int rank = meta.rank;
 		h5::offset_t  default_offset{0,0,0,0,0,0,0};
 		const h5::offset_t& offset = arg::get( default_offset, args...);
 		h5::stride_t  default_stride{1,1,1,1,1,1,1};
@@ -45,17 +44,18 @@ namespace h5 {
 		h5::block_t  default_block{1,1,1,1,1,1,1};
 		const h5::block_t& block = arg::get( default_block, args...);
 
-		hsize_t size = 1;for(int i=0;i<rank;i++) size *= count[i] * block[i];
-		hid_t dapl = h5::get_access_plist( ds );
+		h5::count_t size; // of memory space
+		for(int i=0;i<rank;i++) size[i] = count[i] * block[i];
+		size.rank = rank;
 
-		if( H5Pexist(dapl, H5CPP_DAPL_HIGH_THROUGPUT) ){
-			h5::impl::pipeline_t<impl::basic_pipeline_t>* filters;
-			H5Pget(dapl, H5CPP_DAPL_HIGH_THROUGPUT, &filters);
+		if constexpr( std::is_same<std::string,T>::value ){ // variable, fixed length or dictionary, see H5Dstring.hpp
+			size_t n = 1; for(int i=0;i<rank;i++) n *= size[i];
+			impl::write_strings( ds, meta, meta.memory( size ), meta.select( ds, offset, stride, count, block ), dxpl, ptr, n );
+		}else if( h5::impl::pipeline_base_t* filters = meta.pipeline ){
 			filters->write(ds, offset, stride, block, count, dxpl, ptr);
 		}else{
-			h5::sp_t mem_space = h5::create_simple( size );
-			h5::select_all( mem_space );
-			h5::select_hyperslab( file_space, offset, stride, count, block);
+			const h5::sp_t& mem_space = meta.memory( size );
+			const h5::sp_t& file_space = meta.select( ds, offset, stride, count, block );
 			// this can throw exception
 			h5::write<T>(ds, mem_space, file_space, dxpl, ptr);
 		}
@@ -80,21 +80,8 @@ namespace h5 {
 		default_count = impl::size( ref );
 		const h5::count_t& count = arg::get(default_count, args...);
 
-		// std::string is variable length
-		if constexpr( std::is_same<std::string,element_t>::value ){
-			std::vector<char*> ptr;
-			try {
-				for( const auto& reference:ref)
-            		ptr.push_back( strdup( reference.data()) );
-			} catch( ... ){
-				throw h5::error::io::dataset::write( h5::error::msg::mem_alloc );
-			}
-			// will throw it's own
- 			h5::write(ds, ptr.data(), count, args...);
-        	for( auto p:ptr ) free(p);
-			return ds;
-		}  else // ditto, throws error
-			return h5::write<element_t>(ds, impl::data(ref), count, args...  );
+		// will throw it's own
+		return h5::write<element_t>(ds, impl::data(ref), count, args...  );
 	} catch ( const std::runtime_error& err ){
 		throw h5::error::io::dataset::write( err.what() );
 	}
@@ -137,14 +124,19 @@ namespace h5 {
 		const h5::current_dims_t& current_dims  = arg::get(def_current_dims, args... );
 		const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
 
-		h5::mute();
-		//NOTE: this call is unchecked on purpose, return value -1 means the path doesn't exist along to 
-		//queried leaf node. The missing path will be created by h5::create 
-		h5::ds_t ds = (H5Lexists(fd, dataset_path.c_str(), H5P_DEFAULT ) > 0) ? // will throw error
-			h5::open( fd, dataset_path, dapl) : h5::create<T>(fd, dataset_path, args..., current_dims );
-		h5::unmute();
- 		h5::write<T>(ds, ptr,  args...);
-		return ds;
+		const h5::ds_t* ds = h5::impl::find_ds( fd, dataset_path, dapl ); // see h5::set_ds_cache
+		h5::ds_t ds_;
+		if( !ds ){
+			h5::mute();
+			//NOTE: this call is unchecked on purpose, return value -1 means the path doesn't exist along to 
+			//queried leaf node. The missing path will be created by h5::create 
+			ds_ = (H5Lexists(fd, dataset_path.c_str(), H5P_DEFAULT ) > 0) ? // will throw error
+				h5::open( fd, dataset_path, dapl) : impl::create<T>(fd, dataset_path, ptr, count, args..., current_dims );
+			h5::unmute();
+			ds = &h5::impl::keep_ds( fd, dataset_path, dapl, ds_ );
+		}
+ 		h5::write<T>(*ds, ptr,  args...);
+		return *ds;
 	}
 
  	/** \func_write_hdr
@@ -190,14 +182,19 @@ namespace h5 {
 		const h5::current_dims_t& current_dims  = arg::get(def_current_dims, args... );
 		const h5::dapl_t& dapl = arg::get(h5::default_dapl, args...);
 
-		h5::mute();
-
-		//NOTE: this call is unchecked on purpose, return value -1 means the path doesn't exist along to 
-		//queried leaf node. The missing path will be created by h5::create 
-		h5::ds_t ds = ( H5Lexists(fd, dataset_path.c_str(), H5P_DEFAULT ) > 0 ) ?
-			h5::open( fd, dataset_path, dapl) : h5::create<element_t>(fd, dataset_path, args..., current_dims );
-		h5::unmute();
- 		return h5::write<T>(ds, ref,  args...);
+		const h5::ds_t* ds = h5::impl::find_ds( fd, dataset_path, dapl ); // see h5::set_ds_cache
+		h5::ds_t ds_;
+		if( !ds ){
+			h5::mute();
+
+			//NOTE: this call is unchecked on purpose, return value -1 means the path doesn't exist along to 
+			//queried leaf node. The missing path will be created by h5::create 
+			ds_ = ( H5Lexists(fd, dataset_path.c_str(), H5P_DEFAULT ) > 0 ) ?
+				h5::open( fd, dataset_path, dapl) : impl::create<element_t>(fd, dataset_path, impl::data(ref), count, args..., current_dims );
+			h5::unmute();
+			ds = &h5::impl::keep_ds( fd, dataset_path, dapl, ds_ );
+		}
+ 		return h5::write<T>(*ds, ref,  args...);
 	}
 
    /** \func_write_hdr
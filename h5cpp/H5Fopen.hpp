@@ -31,6 +31,15 @@ namespace h5{
 			   h5::error::io::file::open, h5::error::msg::open_file );
 		return  h5::fd_t{fd};
     }
+	/** @ingroup file-io
+	 * switches file opened for writing to single writer multiple readers mode, readers open it with
+	 * H5F_ACC_RDONLY | H5F_ACC_SWMR_READ; the file must use the latest format, see h5::latest_version,
+	 * and objects must be created before. Packet tables are flushed for readers with h5::swmr_flush
+	 */
+	inline void start_swmr_write( const h5::fd_t& fd ){
+		H5CPP_CHECK_NZ( H5Fstart_swmr_write( static_cast<hid_t>( fd ) ),
+				h5::error::io::file::open, "couldn't start swmr write mode..." );
+	}
 }
 #endif
 
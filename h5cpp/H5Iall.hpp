@@ -29,6 +29,8 @@ namespace h5 { namespace impl {
 	};
 	//forward declarations
 	struct at_t;
+	struct ds_meta_t; // see H5capi.hpp
+	struct ds_cache_t; // see H5Dopen.hpp
 }}
 
 namespace h5 { namespace impl { namespace detail {
@@ -42,6 +44,7 @@ namespace h5 { namespace impl { namespace detail {
 		constexpr int type 		= 0x02;
 		constexpr int dataset	= 0x04;
 		constexpr int attribute	= 0x05;
+		constexpr int file		= 0x06;
 	}
 
 	// base template with T type, the capi_close function, and 
@@ -80,9 +83,11 @@ namespace h5 { namespace impl { namespace detail {
 				H5Iinc_ref( handle );
 		}
 		hid_t& operator =( const hid_t& ref) {
-			handle = ref.handle;
+			if( H5Iis_valid( ref.handle ) ) // inc first: self assignment must not release
+				H5Iinc_ref( ref.handle );
 			if( H5Iis_valid( handle ) )
-				H5Iinc_ref( handle );
+				capi_close( handle );
+			handle = ref.handle;
 			return *this;
 		}
 		/* move ctor must invalidate old handle */
@@ -135,9 +140,47 @@ namespace h5 { namespace impl { namespace detail {
 			this->handle = H5I_UNINIT;
 			this->dapl = H5I_UNINIT;
 		};
+		/* dapl may carry the h5cpp pipeline, see H5Pdapl.hpp, hence its lifespan is tied to 
+		 * the dataset descriptor by reference counting */
+		hid_t( const hid_t& ref ) : parent( ref ), dapl( ref.dapl ) {
+			if( H5Iis_valid( dapl ) )
+				H5Iinc_ref( dapl );
+		}
+		hid_t( hid_t&& ref ) : parent( std::move( ref ) ), dapl( ref.dapl ), meta( std::move( ref.meta ) ) {
+			ref.dapl = H5I_UNINIT;
+		}
+		hid_t& operator =( const hid_t& ref ){
+			parent::operator=( ref );
+			if( H5Iis_valid( ref.dapl ) )
+				H5Iinc_ref( ref.dapl );
+			if( H5Iis_valid( dapl ) )
+				H5Idec_ref( dapl );
+			dapl = ref.dapl;
+			meta.reset();
+			return *this;
+		}
+		~hid_t(){
+			if( H5Iis_valid( dapl ) )
+				H5Idec_ref( dapl );
+		}
 		at_t operator[]( const char arg[] );
 
-		::hid_t dapl;
+		::hid_t dapl = H5I_UNINIT;
+		/* dataspace, type and pipeline of dataset built on first IO call, see h5::impl::get_meta; owned by
+		 * this descriptor: copies start with none, as they may be resized from another thread */
+		mutable std::shared_ptr<h5::impl::ds_meta_t> meta;
+	};
+	/*file id*/
+	template<class T, capi_close_t capi_close>
+	struct hid_t<T,capi_close, true,true,hdf5::file> : public hid_t<T,capi_close,true,true,hdf5::any> {
+		using parent = hid_t<T,capi_close,true,true,hdf5::any>;
+		using parent::hid_t; // is a must because of fd_t{hid_t} ctor 
+		using hidtype = T;
+		hid_t() = default;
+
+		/* datasets kept open for path based IO, see h5::set_ds_cache; shared with copies of the descriptor,
+		 * and released before the file */
+		std::shared_ptr<h5::impl::ds_cache_t> cache;
 	};
 	/*attribute id*/
 	template<class T, capi_close_t capi_close>
@@ -167,6 +210,7 @@ namespace h5 { namespace impl {
 	template <class T, capi_close_t capi_call> using hid_t = detail::hid_t<T,capi_call, true,true,detail::hdf5::any>;
 	template <class T, capi_close_t capi_call> using pid_t = detail::hid_t<T,capi_call, true,true,detail::hdf5::property>;
 	template <class T, capi_close_t capi_call> using did_t = detail::hid_t<T,capi_call, true,true,detail::hdf5::dataset>;
+	template <class T, capi_close_t capi_call> using fid_t = detail::hid_t<T,capi_call, true,true,detail::hdf5::file>;
 }}
 
 /*hide gory details, and stamp out descriptors */
@@ -176,7 +220,8 @@ namespace h5 {
 	#define H5CPP__defpid_t( T_, D_ ) namespace impl{struct T_ final {};} using T_ = impl::pid_t<impl::T_,D_>;
 	#define H5CPP__defdid_t( T_, D_ ) namespace impl{struct T_ final {};} using T_ = impl::did_t<impl::T_,D_>;
 	#define H5CPP__defaid_t( T_, D_ ) namespace impl{struct T_ final {};} using T_ = impl::aid_t<impl::T_,D_>;
-	/*file:  */ H5CPP__defhid_t(fd_t, H5Fclose) /*dataset:*/	H5CPP__defdid_t(ds_t, H5Dclose) /* <- packet table: is specialization enabled */
+	#define H5CPP__deffid_t( T_, D_ ) namespace impl{struct T_ final {};} using T_ = impl::fid_t<impl::T_,D_>;
+	/*file:  */ H5CPP__deffid_t(fd_t, H5Fclose) /*dataset:*/	H5CPP__defdid_t(ds_t, H5Dclose) /* <- packet table: is specialization enabled */
 	/*attrib:*/ H5CPP__defaid_t(at_t, H5Aclose) /*group:  */	H5CPP__defaid_t(gr_t, H5Gclose) /*object:*/	H5CPP__defhid_t(ob_t, H5Oclose)
 	/*space: */ H5CPP__defhid_t(sp_t, H5Sclose) 
 	/*datatype:*/   //H5CPP__defhid_t(dt_t, H5Tclose)
@@ -192,6 +237,7 @@ namespace h5 {
 	H5CPP__defpid_t(ocrl_t,H5Pclose) H5CPP__defpid_t(ocpl_t,H5Pclose)
 	H5CPP__defpid_t(scpl_t,H5Pclose)
 	#undef H5CPP__defaid_t
+	#undef H5CPP__deffid_t
 	#undef H5CPP__defpid_t
 	#undef H5CPP__defhid_t
 }
@@ -8,19 +8,129 @@
 #define  H5CPP_PDAPL_HPP
 
 #define H5CPP_DAPL_HIGH_THROUGPUT "h5cpp_dapl_highthroughput"
+#define H5CPP_DAPL_RESERVE "h5cpp_dapl_reserve"
+#define H5CPP_DAPL_SWMR "h5cpp_dapl_swmr"
 
 namespace h5 { namespace impl {
+	/* the property holds a pointer to pipeline, every copy of the property list -- made by H5Pcopy or
+	 * internally by H5Dopen|H5Dcreate -- gets its own unconfigured instance; the instance is released
+	 * when the property list is closed or the property removed */
 	inline herr_t dapl_pipeline_close( const char *name, size_t size, void *ptr ){
-		delete *static_cast< impl::pipeline_t<impl::basic_pipeline_t>**>( ptr );
+		delete *static_cast< impl::pipeline_base_t**>( ptr );
 		return 0;
 	}
+	inline herr_t dapl_pipeline_delete( ::hid_t prop_id, const char *name, size_t size, void *ptr ){
+		return dapl_pipeline_close( name, size, ptr );
+	}
+	inline herr_t dapl_pipeline_copy( const char *name, size_t size, void *ptr ){
+		impl::pipeline_base_t** value = static_cast< impl::pipeline_base_t**>( ptr );
+		impl::pipeline_base_t* from = *value;
+		*value = from->clone();
+		(*value)->ahead.depth = from->ahead.depth;
+		(*value)->cache.capacity = from->cache.capacity;
+		return 0;
+	}
+	// H5Pequal: property lists with pipelines of the same kind and settings are equal
+	inline int dapl_pipeline_compare( const void* a, const void* b, size_t size ){
+		return (*static_cast<impl::pipeline_base_t* const*>( a ))->equal( **static_cast<impl::pipeline_base_t* const*>( b ) ) ? 0 : 1;
+	}
+	inline ::herr_t dapl_pipeline_insert(::hid_t dapl, impl::pipeline_base_t* ptr ){
+		::herr_t err = H5Pinsert2(dapl, H5CPP_DAPL_HIGH_THROUGPUT, sizeof( impl::pipeline_base_t* ), &ptr,
+				nullptr, nullptr, dapl_pipeline_delete, dapl_pipeline_copy, dapl_pipeline_compare, dapl_pipeline_close);
+		if( err < 0 ) delete ptr;
+		return err;
+	}
 	inline ::herr_t dapl_pipeline_set(::hid_t dapl ){
 		// ignore if already set 
 		if( H5Pexist(dapl, H5CPP_DAPL_HIGH_THROUGPUT) ) return 0;
-		using pipeline = impl::pipeline_t<impl::basic_pipeline_t>;
-	 	pipeline* ptr = new pipeline();
-		return H5Pinsert2(dapl, H5CPP_DAPL_HIGH_THROUGPUT, sizeof( pipeline* ), &ptr,
-				nullptr, nullptr, nullptr, nullptr, nullptr, dapl_pipeline_close);
+		return dapl_pipeline_insert(dapl, new impl::basic_pipeline_t() );
+	}
+	/* returns pipeline carried by property list or nullptr */
+	inline impl::pipeline_base_t* get_pipeline( ::hid_t dapl ){
+		impl::pipeline_base_t* ptr = nullptr;
+		if( H5Iis_valid(dapl) > 0 && H5Pexist(dapl, H5CPP_DAPL_HIGH_THROUGPUT) > 0 )
+			H5Pget(dapl, H5CPP_DAPL_HIGH_THROUGPUT, &ptr);
+		return ptr;
+	}
+	// replaces any previously set pipeline, settings other than the type of the pipeline are kept
+	inline ::herr_t dapl_pipeline_replace(::hid_t dapl, impl::pipeline_base_t* ptr ){
+		if( impl::pipeline_base_t* from = get_pipeline( dapl ) ){
+			ptr->ahead.depth = from->ahead.depth;
+			ptr->cache.capacity = from->cache.capacity;
+			if( H5Premove(dapl, H5CPP_DAPL_HIGH_THROUGPUT) < 0 ){
+				delete ptr;
+				return -1;
+			}
+		}
+		return dapl_pipeline_insert(dapl, ptr );
+	}
+	inline ::herr_t dapl_threaded_pipeline_set(::hid_t dapl, unsigned num_threads ){
+		return dapl_pipeline_replace(dapl, new impl::threaded_pipeline_t( num_threads ) );
+	}
+	inline ::herr_t dapl_async_pipeline_set(::hid_t dapl, unsigned depth ){
+		return dapl_pipeline_replace(dapl, new impl::async_pipeline_t( depth ) );
+	}
+	inline ::herr_t dapl_prefetch_set(::hid_t dapl, unsigned depth ){
+		if( dapl_pipeline_set( dapl ) < 0 ) return -1;
+		get_pipeline( dapl )->ahead.depth = depth;
+		return 0;
+	}
+	inline ::herr_t dapl_decoded_cache_set(::hid_t dapl, size_t nbytes ){
+		if( dapl_pipeline_set( dapl ) < 0 ) return -1;
+		get_pipeline( dapl )->cache.capacity = nbytes;
+		return 0;
+	}
+	// growth policy of packet tables, see h5::pt_t
+	inline ::herr_t dapl_reserve_set(::hid_t dapl, unsigned chunks ){
+		if( H5Pexist(dapl, H5CPP_DAPL_RESERVE) > 0 )
+			return H5Pset(dapl, H5CPP_DAPL_RESERVE, &chunks);
+		return H5Pinsert2(dapl, H5CPP_DAPL_RESERVE, sizeof( unsigned ), &chunks,
+				nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+	}
+	inline unsigned get_reserve( ::hid_t dapl ){
+		unsigned chunks = 0;
+		if( H5Iis_valid(dapl) > 0 && H5Pexist(dapl, H5CPP_DAPL_RESERVE) > 0 )
+			H5Pget(dapl, H5CPP_DAPL_RESERVE, &chunks);
+		return chunks;
+	}
+	// flush policy of packet tables written in SWMR mode, see h5::pt_t
+	struct swmr_flush_t {
+		hsize_t records;
+		unsigned milliseconds;
+	};
+	inline ::herr_t dapl_swmr_set(::hid_t dapl, hsize_t records, unsigned milliseconds ){
+		swmr_flush_t value{ records, milliseconds };
+		if( H5Pexist(dapl, H5CPP_DAPL_SWMR) > 0 )
+			return H5Pset(dapl, H5CPP_DAPL_SWMR, &value);
+		return H5Pinsert2(dapl, H5CPP_DAPL_SWMR, sizeof( swmr_flush_t ), &value,
+				nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+	}
+	// returns false when not set
+	inline bool get_swmr( ::hid_t dapl, swmr_flush_t& value ){
+		if( H5Iis_valid(dapl) <= 0 || H5Pexist(dapl, H5CPP_DAPL_SWMR) <= 0 ) return false;
+		H5Pget(dapl, H5CPP_DAPL_SWMR, &value);
+		return true;
+	}
+	/* returns the property list to be carried along with dataset descriptor with reference count incremented:
+	 * when high throughput pipeline is requested a private copy is made and the pipeline configured for `ds`
+	 */
+	inline ::hid_t dapl_pipeline_open( ::hid_t ds, ::hid_t dapl ){
+		if( get_pipeline( dapl ) == nullptr ){
+			H5Iinc_ref( dapl );
+			return dapl;
+		}
+
+		h5::dapl_t dapl_{ H5Pcopy( dapl ) };
+		h5::dcpl_t dcpl{ H5Dget_create_plist( ds ) };
+		if( H5Pget_layout( static_cast<::hid_t>(dcpl) ) == H5D_CHUNKED && filter::is_supported( static_cast<::hid_t>(dcpl) ) ){
+			::hid_t type_id = H5Dget_type( ds );
+			size_t element_size = H5Tget_size( type_id );
+			H5Tclose( type_id );
+			get_pipeline( static_cast<::hid_t>(dapl_) )->set_cache(dcpl, element_size);
+		} else // direct chunk IO requires chunked layout and filters known to h5cpp, fall back to HDF5 pipeline
+			H5Premove( static_cast<::hid_t>(dapl_), H5CPP_DAPL_HIGH_THROUGPUT );
+		H5Iinc_ref( static_cast<::hid_t>(dapl_) );
+		return static_cast<::hid_t>(dapl_);
 	}
 }}
 
@@ -30,12 +140,40 @@ namespace h5 {
 	using efile_prefix 		   = impl::dapl_call< impl::dapl_args<hid_t,const char*>,H5Pset_efile_prefix>;
 	using virtual_view         = impl::dapl_call< impl::dapl_args<hid_t,H5D_vds_view_t>,H5Pset_virtual_view>;
 	using virtual_printf_gap   = impl::dapl_call< impl::dapl_args<hid_t,hsize_t>,H5Pset_virtual_printf_gap>;
-	//using num_threads  	   	   = impl::dapl_call< impl::dapl_args<hid_t, unsigned char>,impl::dapl_threads>;
+	// high throughput pipeline with filters run on `n` threads, 0 := std::thread::hardware_concurrency()
+	using num_threads          = impl::dapl_call< impl::dapl_args<hid_t,unsigned>,impl::dapl_threaded_pipeline_set>;
+	// high throughput pipeline with chunks written on a background thread while the next ones are compressed,
+	// at most `n` chunks are in flight, 0 := 2; HDF5 must not be called from other threads meanwhile unless the
+	// library is thread safe. Packet tables write in the background only with H5CPP_HAVE_THREADSAFE_IO
+	using async_write          = impl::dapl_call< impl::dapl_args<hid_t,unsigned>,impl::dapl_async_pipeline_set>;
+	// high throughput pipeline reading ahead up to `n` chunks when chunks are accessed in sequence
+	using prefetch             = impl::dapl_call< impl::dapl_args<hid_t,unsigned>,impl::dapl_prefetch_set>;
+	// packet table extends dataset `n` chunks at a time instead of doubling its extent, trimmed on flush
+	using reserve_chunks       = impl::dapl_call< impl::dapl_args<hid_t,unsigned>,impl::dapl_reserve_set>;
+	// packet table in SWMR mode: flushed for readers every `n` records or `ms` milliseconds, 0 := never,
+	// whichever comes first; extent is kept exact
+	using swmr_flush           = impl::dapl_call< impl::dapl_args<hid_t,hsize_t,unsigned>,impl::dapl_swmr_set>;
+	// high throughput pipeline keeping up to `n` bytes of decoded chunks for overlapping reads, LRU eviction
+	using decoded_cache        = impl::dapl_call< impl::dapl_args<hid_t,size_t>,impl::dapl_decoded_cache_set>;
 	namespace flag {
 		using high_throughput      = impl::dapl_call< impl::dapl_args<hid_t>,impl::dapl_pipeline_set>;
 	}
 	const static flag::high_throughput high_throughput;
 
+	/* counters of h5cpp pipeline attached to dataset by its dapl, zero if there is none */
+	struct pipeline_stats_t {
+		size_t prefetch_hits, prefetch_misses;
+		size_t cache_hits, cache_misses, cache_evictions;
+	};
+	inline pipeline_stats_t pipeline_stats( const h5::ds_t& ds ){
+		pipeline_stats_t stats{};
+		if( impl::pipeline_base_t* pipeline = impl::get_pipeline( ds.dapl ) )
+			stats.prefetch_hits = pipeline->ahead.hits, stats.prefetch_misses = pipeline->ahead.misses,
+			stats.cache_hits = pipeline->cache.hits, stats.cache_misses = pipeline->cache.misses,
+			stats.cache_evictions = pipeline->cache.evictions;
+		return stats;
+	}
+
 	const static h5::dapl_t dapl = static_cast<h5::dapl_t>( H5Pcreate(H5P_DATASET_ACCESS) );
 	//const static h5::dapl_t default_dapl = high_throughput;
 	const static h5::dapl_t default_dapl = static_cast<h5::dapl_t>(  H5Pcreate(H5P_DATASET_ACCESS) );
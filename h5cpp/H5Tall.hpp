@@ -35,17 +35,39 @@ namespace h5 { namespace impl { namespace detail {
  * IF the data is not in a continuous memory region then it must be copied! 
  */
 
-#define H5CPP_REGISTER_TYPE_( C_TYPE, H5_TYPE )                                           \
+namespace h5 { namespace impl {
+	/* process wide cache of type descriptors: the id of C++ type `T` is built by `make` on first use, then shared by
+	 * all instances of h5::dt_t<T> through reference counting, instead of building the compound type tree on every IO
+	 * call. Shared ids are read only: H5Tcopy before modifying them. The first id is made under static initialization,
+	 * once the library is closed and reopened the id is replaced with compare and swap: of threads racing to do so
+	 * one id is kept, the others are closed
+	 */
+	template <class T, class F> inline ::hid_t cached_type( F&& make ){
+		static std::atomic<::hid_t> id{ make() };
+		::hid_t current = id.load( std::memory_order_acquire );
+		if( H5Iis_valid( current ) > 0 )
+			return current; // reference of the cache, each h5::dt_t<T> takes one of its own
+		::hid_t fresh = make();
+		if( id.compare_exchange_strong( current, fresh, std::memory_order_acq_rel ) )
+			return fresh;
+		H5Tclose( fresh ); // `current` is the one made by another thread
+		return current;
+	}
+}}
+
+/* NEW_ID: expression returning a type id the cache takes ownership of */
+#define H5CPP_REGISTER_TYPE_ID_( C_TYPE, NEW_ID )                                           \
 namespace h5 { namespace impl { namespace detail { 	                                      \
 	template <> struct hid_t<C_TYPE,H5Tclose,true,true,hdf5::type> : public dt_p<C_TYPE> {\
 		using parent = dt_p<C_TYPE>;                                                      \
 		using parent::hid_t;                                                              \
 		using hidtype = C_TYPE;                                                           \
-		hid_t() : parent( H5Tcopy( H5_TYPE ) ) { 										  \
-			hid_t id = static_cast<hid_t>( *this );                                       \
+		hid_t() : parent( h5::impl::cached_type<C_TYPE>( []{                              \
+			::hid_t id = NEW_ID;                                                          \
 			if constexpr ( std::is_pointer<C_TYPE>::value )                               \
 					H5Tset_size (id,H5T_VARIABLE), H5Tset_cset(id, H5T_CSET_UTF8);        \
-		}                                                                                 \
+			return id;                                                                    \
+		})){}                                                                             \
 	};                                                                                    \
 }}}                                                                                       \
 namespace h5 {                                                                            \
@@ -54,6 +76,8 @@ namespace h5 {
 	};                                                                                    \
 }                                                                                         \
 
+#define H5CPP_REGISTER_TYPE_( C_TYPE, H5_TYPE ) H5CPP_REGISTER_TYPE_ID_( C_TYPE, H5Tcopy( H5_TYPE ) )
+
 /* registering integral data-types for NATIVE ones, which means all data is stored in the same way 
  * in file and memory: TODO: allow different types for file storage
  * */
@@ -70,7 +94,9 @@ namespace h5 {
 	H5CPP_REGISTER_TYPE_(char*, H5T_C_S1)
 
 
-#define H5CPP_REGISTER_STRUCT( POD_STRUCT ) H5CPP_REGISTER_TYPE_( POD_STRUCT, h5::register_struct<POD_STRUCT>() )
+// the compound type built by h5::register_struct<POD_STRUCT>() is owned by the cache, along with any intermediate
+// types left open
+#define H5CPP_REGISTER_STRUCT( POD_STRUCT ) H5CPP_REGISTER_TYPE_ID_( POD_STRUCT, h5::register_struct<POD_STRUCT>() )
 
 /* type alias is responsible for ALL type maps through H5CPP if you want to screw things up
  * start here.
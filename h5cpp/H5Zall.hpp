@@ -34,71 +34,118 @@ namespace h5 { namespace impl { namespace filter {
 		std::string name;
 	};
 
-	using call_t = size_t (*)(void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[] );
-	inline size_t mock( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[] ){
-		memcpy(dst,src,size);
-		return size;
-	}
-	inline size_t deflate( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[]){
-		memcpy(dst,src,size);
-		return size;
-	}
-	inline size_t scaleoffset( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[]){
-		memcpy(dst,src,size);
-		return size;
-	}
-	inline size_t gzip( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[]){
-		size_t nbytes = size;
-		int ret = compress2( (unsigned char*)dst, &nbytes, (const unsigned char*)src, size, params[0]);
-		return nbytes;
-	}
-	inline size_t szip( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[]){
-		memcpy(dst,src,size);
-		return size;
-	}
-	inline size_t nbit( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[]){
-		memcpy(dst,src,size);
-		return size;
+	/* filter callbacks transform `size` bytes from `src` into `dst` of `capacity` bytes and return the number of bytes
+	 * in `dst`, or 0 on failure; which is not an error for optional filters: the chunk is stored without this filter.
+	 * params[] are the HDF5 filter client data values: cd_values[]
+	 */
+	using call_t = size_t (*)(void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[], size_t capacity );
+	// encode -- decode pairs, either both set or nullptr: filter not available in h5cpp pipeline
+	struct callback_t {
+		call_t encode, decode;
+	};
+
+	inline size_t gzip( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[], size_t capacity ){
+		// no gain in compression is failure, this also keeps sizes of compressed and skipped chunks apart:
+		// H5Dwrite_chunk doesn't update the filter mask of a chunk rewritten with the same size
+		uLongf nbytes = size - 1;
+		if( size < 2 ) return 0;
+		int ret = compress2( (unsigned char*)dst, &nbytes, (const unsigned char*)src, size, n ? params[0] : Z_DEFAULT_COMPRESSION );
+		return ret == Z_OK ? nbytes : 0;
 	}
-	inline size_t fletcher32( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[]){
-		memcpy(dst,src,size);
-		return size;
+	inline size_t gunzip( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[], size_t capacity ){
+		uLongf nbytes = capacity;
+		int ret = uncompress( (unsigned char*)dst, &nbytes, (const unsigned char*)src, size );
+		return ret == Z_OK ? nbytes : 0;
 	}
-
-	inline size_t add( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[] ){
-		memcpy(dst,src,size);
+	/* HDF5 byte shuffle, see H5Zshuffle.hpp; params[0] is the element size,
+	 * trailing bytes not making a whole element are copied as is */
+	inline size_t shuffle( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[], size_t capacity ){
+		size_t M = n ? params[0] : 1, N = size / M;
+		if( M < 2 || N < 2 ){
+			memcpy(dst,src,size);
+			return size;
+		}
+		shuffle_::shuffle( static_cast<unsigned char*>(dst), static_cast<const unsigned char*>(src), N, M );
+		memcpy( static_cast<char*>(dst) + N*M, static_cast<const char*>(src) + N*M, size - N*M );
 		return size;
 	}
-	inline size_t shuffle( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[] ){
-		memcpy(dst,src,size);
+	inline size_t unshuffle( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[], size_t capacity ){
+		size_t M = n ? params[0] : 1, N = size / M;
+		if( M < 2 || N < 2 ){
+			memcpy(dst,src,size);
+			return size;
+		}
+		shuffle_::unshuffle( static_cast<unsigned char*>(dst), static_cast<const unsigned char*>(src), N, M );
+		memcpy( static_cast<char*>(dst) + N*M, static_cast<const char*>(src) + N*M, size - N*M );
 		return size;
 	}
-	inline size_t jpeg( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[] ){
-		memcpy(dst,src,size);
-		return size;
+	// same as H5_checksum_fletcher32
+	inline uint32_t checksum_fletcher32( const unsigned char* data, size_t size ){
+		uint32_t sum1 = 0, sum2 = 0;
+		for( size_t len = size / 2; len; ){
+			size_t tlen = len > 360 ? 360 : len;
+			len -= tlen;
+			do {
+				sum1 += (uint32_t)(((uint16_t)data[0]) << 8) | ((uint16_t)data[1]);
+				data += 2;
+				sum2 += sum1;
+			} while( --tlen );
+			sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+			sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+		}
+		if( size % 2 ){
+			sum1 += (uint32_t)(((uint16_t)*data) << 8);
+			sum2 += sum1;
+			sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+			sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+		}
+		sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+		sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+		return (sum2 << 16) | sum1;
 	}
-	inline size_t disperse( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[] ){
-		memcpy(dst,src,size);
-		return size;
+	// checksum is appended in little endian byte order
+	inline size_t fletcher32( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[], size_t capacity ){
+		if( size + 4 > capacity ) return 0;
+		unsigned char* out = static_cast<unsigned char*>( dst );
+		memcpy( out, src, size );
+		uint32_t sum = checksum_fletcher32( out, size );
+		for( int i=0; i<4; i++ )
+			out[size + i] = (sum >> (8*i)) & 0xff;
+		return size + 4;
 	}
-	inline size_t error( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[] ){
-		throw std::runtime_error("invalid filter");
+	inline size_t fletcher32_check( void* dst, const void* src, size_t size, unsigned flags, size_t n, const unsigned params[], size_t capacity ){
+		if( size < 4 ) return 0;
+		const unsigned char* in = static_cast<const unsigned char*>( src );
+		size -= 4;
+		uint32_t stored = 0, sum = checksum_fletcher32( in, size );
+		for( int i=0; i<4; i++ )
+			stored |= uint32_t( in[size + i] ) << (8*i);
+		// files created with HDF5 < 1.6.3 on little endian systems have bytes swapped
+		uint32_t reversed = ((sum & 0xff) << 24) | ((sum & 0xff00) << 8) | ((sum >> 8) & 0xff00) | (sum >> 24);
+		if( stored != sum && stored != reversed ) return 0;
+		memcpy( dst, src, size );
 		return size;
 	}
-	inline call_t get_callback( H5Z_filter_t filter_id ){
-
+	inline callback_t get_callback( H5Z_filter_t filter_id ){
 		switch( filter_id ){
-			case H5Z_FILTER_DEFLATE: return filter::gzip;
-			case H5Z_FILTER_SHUFFLE: return filter::shuffle;
-			case H5Z_FILTER_FLETCHER32: return filter::fletcher32;
-			case H5Z_FILTER_SZIP: return filter::szip;
-			case H5Z_FILTER_NBIT: return filter::nbit;
-			case H5Z_FILTER_SCALEOFFSET: return filter::scaleoffset;
-			default:
-					return filter::error;
+			case H5Z_FILTER_DEFLATE: return {filter::gzip, filter::gunzip};
+			case H5Z_FILTER_SHUFFLE: return {filter::shuffle, filter::unshuffle};
+			case H5Z_FILTER_FLETCHER32: return {filter::fletcher32, filter::fletcher32_check};
+			default: // H5Z_FILTER_SZIP, H5Z_FILTER_NBIT, H5Z_FILTER_SCALEOFFSET, third party filters
+					return {nullptr, nullptr};
 		}
 	}
-
+	// true if all filters of the dataset creation property list are implemented in h5cpp pipeline
+	inline bool is_supported( ::hid_t dcpl ){
+		int N = H5Pget_nfilters( dcpl );
+		unsigned flags, filter_config;
+		for( int i=0; i<N; i++ ){
+			size_t n = 0;
+			if( get_callback( H5Pget_filter2( dcpl, i, &flags, &n, nullptr, 0, nullptr, &filter_config )).encode == nullptr )
+				return false;
+		}
+		return N <= H5CPP_MAX_FILTER;
+	}
 
 }}}
 #endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ *
+ */
+
+#ifndef  H5CPP_ZCACHE_HPP
+#define  H5CPP_ZCACHE_HPP
+
+/* chunks are keyed by their offset, each of them takes `buffer_size` bytes of the budget; buffers of evicted
+ * chunks are recycled. The cache sees only chunks read and written through the same pipeline: writes by other
+ * handles or processes are not visible, same as with the chunk cache of HDF5.
+ */
+inline size_t h5::impl::decoded_cache_t::hash_t::operator()( const key_t& key ) const {
+	size_t value = 0;
+	for( hsize_t k: key )
+		value = value * 0x100000001b3ULL ^ std::hash<hsize_t>()( k );
+	return value;
+}
+
+inline h5::impl::decoded_cache_t::key_t h5::impl::decoded_cache_t::key( const hsize_t* offset ) const {
+	key_t key{};
+	std::copy(offset, offset + rank, key.begin());
+	return key;
+}
+
+inline void h5::impl::decoded_cache_t::reset( size_t buffer_size, size_t block_size, hsize_t rank ){
+	index.clear(); lru.clear();
+	this->buffer_size = buffer_size, this->block_size = block_size, this->rank = rank;
+	size = 0;
+}
+
+inline bool h5::impl::decoded_cache_t::get( const hsize_t* offset, void* data ){
+	if( !enabled() ) return false;
+	auto it = index.find( key( offset ) );
+	if( it == index.end() ){
+		misses++;
+		return false;
+	}
+	lru.splice( lru.begin(), lru, it->second );
+	memcpy( data, it->second->ptr.get(), block_size );
+	hits++;
+	return true;
+}
+
+inline void h5::impl::decoded_cache_t::put( const hsize_t* offset, const void* data ){
+	if( !enabled() ) return;
+	key_t key = this->key( offset );
+	auto it = index.find( key );
+	if( it != index.end() ) // already cached: refresh content
+		lru.splice( lru.begin(), lru, it->second );
+	else if( size + buffer_size <= capacity ){
+		h5::impl::unique_ptr<char> ptr{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		if( !ptr ) return; // cache is best effort
+		lru.push_front( entry_t{key, std::move( ptr )} );
+		index.emplace( key, lru.begin() );
+		size += buffer_size;
+	} else { // reuse buffer of least recently used chunk
+		index.erase( lru.back().key );
+		lru.splice( lru.begin(), lru, std::prev( lru.end() ) );
+		lru.front().key = key;
+		index.emplace( key, lru.begin() );
+		evictions++;
+	}
+	memcpy( lru.front().ptr.get(), data, block_size );
+}
+
+inline void h5::impl::decoded_cache_t::drop( const hsize_t* offset ){
+	if( index.empty() ) return;
+	auto it = index.find( key( offset ) );
+	if( it == index.end() ) return;
+	lru.erase( it->second );
+	index.erase( it );
+	size -= buffer_size;
+}
+#endif
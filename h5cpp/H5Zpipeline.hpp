@@ -15,11 +15,179 @@ namespace h5{ namespace impl {
 	enum struct filter_direction_t {
 		forward = 0, reverse = 1
 	};
+	/* box copy kernels with the loop nest unrolled for rank `R` at compile time, selected once per pipeline in
+	 * `set_cache`; rows shorter than H5CPP_SHORT_ROW bytes are moved in fixed size words instead of calling memcpy */
+	namespace copy {
+		using kernel_t = void (*)( char* dst, const hsize_t* dst_stride, const char* src, const hsize_t* src_stride,
+				const hsize_t* extent, size_t length );
+		using select_t = kernel_t (*)( size_t length );
+
+		template <size_t W> struct row_t { // W = 0 is any length
+			static inline void copy( char* dst, const char* src, size_t length ){
+				if( W == 0 ) memcpy(dst, src, length);
+				else for(size_t i=0; i<length; i+=W) memcpy(dst + i, src + i, W);
+			}
+		};
+		template <int R, class Row> struct box_t {
+			static inline void copy( char* dst, const hsize_t* dst_stride, const char* src, const hsize_t* src_stride,
+					const hsize_t* extent, size_t length ){
+				for(hsize_t i=0; i<*extent; i++, dst += *dst_stride, src += *src_stride)
+					box_t<R-1,Row>::copy(dst, dst_stride + 1, src, src_stride + 1, extent + 1, length);
+			}
+		};
+		template <class Row> struct box_t<1,Row> {
+			static inline void copy( char* dst, const hsize_t*, const char* src, const hsize_t*, const hsize_t*, size_t length ){
+				Row::copy(dst, src, length);
+			}
+		};
+		template <int R> void kernel( char* dst, const hsize_t* dst_stride, const char* src, const hsize_t* src_stride,
+				const hsize_t* extent, size_t length ){
+			box_t<R,row_t<0>>::copy(dst, dst_stride, src, src_stride, extent, length);
+		}
+		template <int R, size_t W> void short_kernel( char* dst, const hsize_t* dst_stride, const char* src,
+				const hsize_t* src_stride, const hsize_t* extent, size_t length ){
+			box_t<R,row_t<W>>::copy(dst, dst_stride, src, src_stride, extent, length);
+		}
+		template <int R> kernel_t select( size_t length ){
+			if( length > H5CPP_SHORT_ROW ) return kernel<R>;
+			return length % 16 == 0 ? short_kernel<R,16> : length % 8 == 0 ? short_kernel<R,8>
+				: length % 4 == 0 ? short_kernel<R,4> : kernel<R>;
+		}
+		template <int R> select_t select_rank( hsize_t rank ){
+			if constexpr ( R == 1 ) return select<1>;
+			else return rank == R ? select<R> : select_rank<R-1>( rank );
+		}
+		inline select_t select( hsize_t rank ){
+			return select_rank<H5CPP_MAX_RANK>( rank );
+		}
+	}
+	// selected indices of a chunk along a dimension: [chunk, chunk + length) maps to [user, user + length)
+	struct run_t { hsize_t chunk, user, length; };
+	// copies rows of runs between chunk and user memory; `E` > 0 is the element size when all runs are single elements
+	template <size_t E, bool to_chunk>
+	inline void copy_runs( char* chunk, char* user, const run_t* run, size_t n, size_t element_size ){
+		for(size_t i=0; i<n; i++){
+			char *c = chunk + run[i].chunk * element_size, *u = user + run[i].user * element_size;
+			size_t length = E ? E : run[i].length * element_size;
+			if( to_chunk ) memcpy(c, u, length);
+			else memcpy(u, c, length);
+		}
+	}
+
+	struct pipeline_base_t;
+	/* read ahead: a sequential scan is detected from consecutive chunk requests with the same positive stride
+	 * in the chunk grid, then the next `depth` chunks are decoded on a background thread into a pool of as
+	 * many slots; see H5Zprefetch.hpp */
+	struct read_ahead_t {
+		read_ahead_t( pipeline_base_t* owner ) : depth(0), hits(0), misses(0), owner( owner ), block_size(0), chunks(0) {}
+		~read_ahead_t(){ stop(); }
+		// stops background thread and releases the pool, called when pipeline is (re)configured
+		void reset( size_t buffer_size, size_t block_size, hsize_t rank, const hsize_t* B );
+		// called at the start of each read: dataset extent `D` defines the chunk grid the access pattern is tracked in,
+		// chunks scheduled from now on are read from `ds`
+		void extent( ::hid_t ds, const hsize_t* D );
+		// copies decoded chunk at `offset` into `data` and schedules the next ones, returns false on miss
+		bool get( const hsize_t* offset, void* data );
+		// invalidates the pool, called before writes
+		void drop();
+		void stop();
+
+		unsigned depth;
+		size_t hits, misses;
+
+		private:
+		enum struct state_t { empty = 0, reserved = 1, queued = 2, loading = 3, ready = 4, failed = 5 };
+		struct slot_t {
+			slot_t() : state( state_t::empty ), stamp(0) {}
+			h5::impl::unique_ptr<char> raw, tmp, data; // stored bytes, filter scratch and decoded chunk
+			::hid_t ds; // at the time of scheduling, pipeline members may change meanwhile
+			hsize_t index, offset[H5CPP_MAX_RANK];
+			size_t length;
+			uint32_t mask;
+			state_t state;
+			size_t stamp;
+		};
+		void start();
+		void loader();
+		bool issue( hsize_t index, hsize_t current );
+
+		pipeline_base_t* owner;
+		::hid_t ds;
+		size_t buffer_size, block_size, clock;
+		// first: chunk the read started with, last: highest chunk index seen, delta: last step of `last`
+		hsize_t rank, B[H5CPP_MAX_RANK], G[H5CPP_MAX_RANK], chunks, first, last, run, delta;
+		bool done, begin, repeat;
+		std::vector<slot_t> pool;
+		std::deque<slot_t*> pending;
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable on_pending, on_loaded;
+	};
+
+	/* decoded chunks kept between calls, least recently used ones are evicted once `capacity` bytes are exceeded;
+	 * direct chunk IO bypasses the chunk cache of HDF5, see H5Zcache.hpp */
+	struct decoded_cache_t {
+		decoded_cache_t() : capacity(0), hits(0), misses(0), evictions(0), size(0), buffer_size(0), block_size(0), rank(0) {}
+		// releases all chunks, called when pipeline is (re)configured
+		void reset( size_t buffer_size, size_t block_size, hsize_t rank );
+		// copies decoded chunk at `offset` into `data`, returns false on miss
+		bool get( const hsize_t* offset, void* data );
+		// keeps a copy of decoded chunk at `offset`, evicting the least recently used ones to make room
+		void put( const hsize_t* offset, const void* data );
+		// invalidates chunk at `offset`, called before the chunk is written
+		void drop( const hsize_t* offset );
+		bool enabled() const { return capacity >= buffer_size && block_size; }
+
+		size_t capacity; // budget in bytes, 0 := disabled
+		size_t hits, misses, evictions;
+
+		private:
+		typedef std::array<hsize_t, H5CPP_MAX_RANK> key_t;
+		struct hash_t {
+			size_t operator()( const key_t& key ) const;
+		};
+		struct entry_t {
+			key_t key;
+			h5::impl::unique_ptr<char> ptr;
+		};
+		key_t key( const hsize_t* offset ) const;
+
+		std::list<entry_t> lru; // most recently used first
+		std::unordered_map<key_t, std::list<entry_t>::iterator, hash_t> index;
+		size_t size, buffer_size, block_size;
+		hsize_t rank;
+	};
+
+	/* type erased interface so that different pipelines may hide behind the same dapl property,
+	 * see H5Pdapl.hpp; per chunk calls are resolved at compile time with CRTP idiom */
+	struct pipeline_base_t {
+		pipeline_base_t() : ahead( this ) {}
+		virtual ~pipeline_base_t(){};
+		virtual pipeline_base_t* clone() const = 0;
+		virtual void set_cache( const h5::dcpl_t& dcpl, size_t element_size ) = 0;
+		virtual void write(const h5::ds_t& ds, const h5::offset_t& start, const h5::stride_t& stride, const h5::block_t& block,
+				const h5::count_t& count, const h5::dxpl_t& dxpl, const void* ptr) = 0;
+		virtual void read(const h5::ds_t& ds, const h5::offset_t& start, const h5::stride_t& stride, const h5::block_t& block,
+				const h5::count_t& count, const h5::dxpl_t& dxpl, void* ptr) = 0;
+		// stored bytes of chunk at `offset` into `raw`, returns 0 for chunks not yet allocated
+		virtual size_t read_raw( ::hid_t ds, ::hid_t dxpl, const hsize_t* offset, void* raw, uint32_t& mask ) const = 0;
+		// runs filter chain in reverse direction from `in` to `data`, with `in` and `tmp` holding intermediate results
+		virtual void decode_raw( void* in, void* tmp, size_t length, uint32_t mask, void* data, size_t nbytes ) const = 0;
+		// same kind and settings as `other`, dapl carrying either compare equal, see H5Pdapl.hpp
+		virtual bool equal( const pipeline_base_t& other ) const {
+			return typeid( *this ) == typeid( other ) && ahead.depth == other.ahead.depth && cache.capacity == other.cache.capacity;
+		}
+
+		read_ahead_t ahead;
+		decoded_cache_t cache;
+	};
 
 	template <class Derived>
-	struct pipeline_t {
-		pipeline_t(){};
-		~pipeline_t(){};
+	struct pipeline_t : public pipeline_base_t {
+		pipeline_t() : tail(0), rank(0), clock(0), block_size(0), buffer_size(0) {};
+		~pipeline_t(){ ahead.stop(); } // background decoding calls into this object
+		size_t read_raw( ::hid_t ds, ::hid_t dxpl, const hsize_t* offset, void* raw, uint32_t& mask ) const;
+		void decode_raw( void* in, void* tmp, size_t length, uint32_t mask, void* data, size_t nbytes ) const;
 		void set_cache( const h5::dcpl_t& dcpl, size_t element_size );
 		void write(const h5::ds_t& ds, const h5::offset_t& start, const h5::stride_t& stride, const h5::block_t& block, const h5::count_t& count,
 				const h5::dxpl_t& dxpl, const void* ptr);
@@ -28,43 +196,169 @@ namespace h5{ namespace impl {
 				const h5::dxpl_t& dxpl, void* ptr);
 
 		void write_chunk(  const hsize_t* offset, size_t nbytes, const void* ptr ){
+			cache.drop( offset );
 			static_cast<Derived*>(this)->write_chunk_impl(offset, nbytes, ptr);
 		}
 		void read_chunk( const hsize_t* offset, size_t nbytes, void* ptr ){
 			static_cast<Derived*>(this)->read_chunk_impl(offset, nbytes, ptr);
 		}
+		// decoded chunk from cache or read ahead pool when available, otherwise with read_chunk
+		void read_through( const hsize_t* offset, void* ptr ){
+			if( cache.get( offset, ptr ) ) return;
+			if( !ahead.get( offset, ptr ) ) read_chunk( offset, block_size, ptr );
+			cache.put( offset, ptr );
+		}
+		// blocks until all chunks passed to write_chunk are on disk
+		void flush(){
+			static_cast<Derived*>(this)->flush_impl();
+		}
 		void split_to_chunk_write(filter_direction_t direction, const hsize_t* offset, const hsize_t* dims, const void* ptr );
 		void split_to_chunk_read(filter_direction_t direction, const hsize_t* offset, const hsize_t* dims, void* ptr );
+		// hyperslabs with gaps between blocks: only chunks holding selected elements are visited, forward direction
+		// gathers `ptr` into chunks, reverse scatters chunks into `ptr` 
+		void split_to_chunk_strided(filter_direction_t direction, const hsize_t* offset, const hsize_t* stride,
+				const hsize_t* block, const hsize_t* count, void* ptr );
+		// computes `runs` of chunk at grid position `g`, returns false if it holds no selected elements
+		bool select_runs( const hsize_t* g, const hsize_t* O, const hsize_t* S, const hsize_t* K, const hsize_t* Q,
+				int& covered );
+		// true if whole chunks are contiguous blocks of user memory, valid after N and B are set in split_to_chunk_xxx
+		bool is_contiguous() const;
+		// sets C to origin of chunk at grid position `g` and [lo,hi) to its intersection with selection at `O` of N
+		// returns 0: partial chunk, 1: chunk covered within the dataset extent, 2: chunk covered entirely 
+		int intersect( const hsize_t* g, const hsize_t* O, hsize_t* lo, hsize_t* hi );
+		// copies box of `extent` between dense arrays of `dst_dims` and `src_dims` from and to the given start
+		void copy_box( char* dst, const hsize_t* dst_dims, const hsize_t* dst_start,
+				const char* src, const hsize_t* src_dims, const hsize_t* src_start, const hsize_t* extent ) const;
+		// decoded content of chunk at `offset` for read-modify-write, from edge cache or disk
+		char* fetch_chunk( const hsize_t* offset );
+		void evict_chunk( const hsize_t* offset );
+		// runs filter chain in forward direction alternating between buffers `a` and `b`, where `b` may alias `in`
+		// returns the buffer holding the result, length is updated with the size of encoded data and
+		// mask with the skipped optional filters
+		const void* encode( void* a, void* b, const void* in, size_t& length, uint32_t& mask ) const;
+		// reads chunk at `offset` with direct chunk IO and runs filter chain in reverse direction
+		void decode_chunk( const hsize_t* offset, size_t nbytes, void* data );
+		// size of chunk at `offset` of dataset `ds` in the file, 0 if not allocated
+		static hsize_t stored_size( ::hid_t ds, const hsize_t* offset );
+		// H5Dwrite_chunk with the filter mask recorded also when the chunk is rewritten with the same size
+		static herr_t write_raw( ::hid_t ds, ::hid_t dxpl, uint32_t mask, const hsize_t* offset, size_t length, const void* data );
 
 		char *chunk0, *chunk1;
 		hsize_t tail,rank;
 
 	public:
-		void push( filter::call_t filter );
+		void push( filter::callback_t filter );
 		void pop();
+		// filter scratch borrowed from the caller, at least `buffer_size` each and not used concurrently; own
+		// buffers are released, and allocated again when `a` is null, see h5::pt_manager_t
+		void set_scratch( char* a, char* b );
 
-		std::unique_ptr<char> ptr0, ptr1; // will call std::free on dtor
-		filter::call_t filter[H5CPP_MAX_FILTER];
+		h5::impl::unique_ptr<char> ptr0, ptr1; // will call std::free on dtor
+		filter::callback_t filter[H5CPP_MAX_FILTER];
+		// n: elements in chunk, C: chunk offset, D: dataset extent, N: selection dims, B: chunk dims
 		hsize_t n,
 				C[H5CPP_MAX_RANK], D[H5CPP_MAX_RANK],
-				N[H5CPP_MAX_RANK], B[H5CPP_MAX_RANK], Rx[H5CPP_MAX_RANK],Ry[H5CPP_MAX_RANK];
+				N[H5CPP_MAX_RANK], B[H5CPP_MAX_RANK];
+		struct edge_t { // recently modified partial chunks, see read-modify-write in split_to_chunk_write
+			h5::impl::unique_ptr<char> ptr;
+			hsize_t offset[H5CPP_MAX_RANK];
+			size_t stamp; // 0 := unused slot
+		} edge[H5CPP_MAX_EDGE_CHUNK];
+		size_t clock;
+		copy::select_t select; // box copy kernels for `rank`
+		std::vector<run_t> runs[H5CPP_MAX_RANK]; // see split_to_chunk_strided
 		unsigned cd_values[H5CPP_MAX_FILTER][H5CPP_MAX_FILTER_PARAM],
 				flags[H5CPP_MAX_FILTER];
-		size_t 	block_size, element_size, cd_size[H5CPP_MAX_FILTER];
+		size_t 	block_size, buffer_size, element_size, cd_size[H5CPP_MAX_FILTER];
 		h5::dcpl_t dcpl;
-		h5::dxpl_t dxpl;
-		h5::ds_t ds;
+		// not owned: the pipeline itself is owned by the dataset through its dapl, see H5Pdapl.hpp
+		::hid_t dxpl, ds;
 	};
 
 	struct basic_pipeline_t : public pipeline_t<basic_pipeline_t>{
+		pipeline_base_t* clone() const { return new basic_pipeline_t(); }
 		void write_chunk_impl( const hsize_t* offset, size_t nbytes, const void* ptr );
 		void read_chunk_impl( const hsize_t* offset, size_t nbytes, void* ptr );
+		void flush_impl(){}
 	};
+	/* filter chain is executed on a pool of workers, while a dedicated thread writes encoded chunks
+	 * in submission order; see H5Zpipeline_threaded.hpp */
 	struct threaded_pipeline_t : public pipeline_t<threaded_pipeline_t>{
-		void write_chunk_impl( const hsize_t* offset, size_t nbytes, const void* ptr ){
+		threaded_pipeline_t( unsigned num_threads = 0 );
+		~threaded_pipeline_t();
+		pipeline_base_t* clone() const { return new threaded_pipeline_t( num_threads ); }
+		bool equal( const pipeline_base_t& other ) const {
+			return pipeline_base_t::equal( other ) && num_threads == static_cast<const threaded_pipeline_t&>( other ).num_threads;
 		}
-		void read_chunk_impl( const hsize_t* offset, size_t nbytes, void* ptr ){
+		void write_chunk_impl( const hsize_t* offset, size_t nbytes, const void* ptr );
+		void read_chunk_impl( const hsize_t* offset, size_t nbytes, void* ptr );
+		void flush_impl();
+
+		private:
+		enum struct state_t { idle = 0, queued = 1, encoded = 2 };
+		struct job_t {
+			job_t() : state( state_t::idle ) {}
+			h5::impl::unique_ptr<char> ptr0, ptr1; // scratch buffers for filter chain
+			const void* out;
+			size_t length;
+			uint32_t mask;
+			state_t state;
+			hsize_t offset[H5CPP_MAX_RANK];
+		};
+		void start();
+		void stop();
+		void encoder();
+		void writer();
+
+		unsigned num_threads;
+		size_t capacity; // block size the job ring was allocated for
+		hsize_t submitted, written;
+		bool done;
+		std::exception_ptr error;
+		std::vector<job_t> ring;
+		std::deque<size_t> queue;
+		std::vector<std::thread> workers;
+		std::thread io;
+		std::mutex mutex;
+		std::condition_variable on_queued, on_encoded, on_written;
+	};
+	/* filter chain runs in the calling thread, while a background thread writes encoded chunks from a
+	 * ring of `depth` slots; see H5Zpipeline_async.hpp */
+	struct async_pipeline_t : public pipeline_t<async_pipeline_t>{
+		async_pipeline_t( unsigned depth = 0 );
+		~async_pipeline_t();
+		pipeline_base_t* clone() const { return new async_pipeline_t( depth ); }
+		bool equal( const pipeline_base_t& other ) const {
+			return pipeline_base_t::equal( other ) && depth == static_cast<const async_pipeline_t&>( other ).depth;
 		}
+		void write_chunk_impl( const hsize_t* offset, size_t nbytes, const void* ptr );
+		void read_chunk_impl( const hsize_t* offset, size_t nbytes, void* ptr );
+		void flush_impl();
+
+		unsigned depth; // chunks in flight, also used by h5::pt_t, see H5Dappend.hpp
+
+		private:
+		struct slot_t {
+			slot_t() : busy( false ) {}
+			h5::impl::unique_ptr<char> ptr0, ptr1; // encoded chunk is in either of them
+			const void* out;
+			size_t length;
+			uint32_t mask;
+			bool busy;
+			hsize_t offset[H5CPP_MAX_RANK];
+		};
+		void start();
+		void stop();
+		void writer();
+
+		size_t capacity; // block size the ring was allocated for
+		hsize_t submitted, written;
+		bool done;
+		std::exception_ptr error;
+		std::vector<slot_t> ring;
+		std::thread io;
+		std::mutex mutex;
+		std::condition_variable on_submitted, on_written;
 	};
 	struct romio_pipeline_t : public pipeline_t<romio_pipeline_t>{
 		void write_chunk_impl( const hsize_t* offset, size_t nbytes, const void* ptr ){
@@ -86,10 +380,21 @@ inline void h5::impl::pipeline_t<Derived>::write(
 				const h5::dxpl_t& dxpl, const void* ptr){
 
 	h5::offset_t offset_; h5::count_t count_;
-	for(int i=0; i<rank; i++)
+	bool strided = false;
+	for(hsize_t i=0; i<rank; i++){
 		offset_[i] = offset[i], count_[i] = count[i] * block[i];
-	this->dxpl = dxpl; this->ds = ds;
-	split_to_chunk_write(filter_direction_t::forward, offset_.begin(), count_.begin(), ptr );
+		if( count[i] > 1 && stride[i] < block[i] )
+			throw h5::error::io::dataset::write( H5CPP_ERROR_MSG("blocks of hyperslab overlap: stride < block..."));
+		strided |= count[i] > 1 && stride[i] != block[i];
+	}
+	this->dxpl = static_cast<::hid_t>( dxpl ); this->ds = static_cast<::hid_t>( ds );
+	ahead.drop(); // prefetched chunks may be overwritten
+	if( strided )
+		split_to_chunk_strided(filter_direction_t::forward, offset_.begin(), stride.begin(), block.begin(), count.begin(),
+				const_cast<void*>( ptr ));
+	else // adjacent blocks are a single box
+		split_to_chunk_write(filter_direction_t::forward, offset_.begin(), count_.begin(), ptr );
+	flush();
 }
 
 template< class Derived>
@@ -98,10 +403,24 @@ inline void h5::impl::pipeline_t<Derived>::read(
 				const h5::dxpl_t& dxpl, void* ptr){
 
 	h5::offset_t offset_; h5::count_t count_;
-	for(int i=0; i<rank; i++)
+	bool strided = false;
+	for(hsize_t i=0; i<rank; i++){
 		offset_[i] = offset[i], count_[i] = count[i] * block[i];
-	this->dxpl = dxpl; this->ds = ds;
-	split_to_chunk_read(filter_direction_t::reverse, offset_.begin(), count_.begin(), ptr );
+		if( count[i] > 1 && stride[i] < block[i] )
+			throw h5::error::io::dataset::read( H5CPP_ERROR_MSG("blocks of hyperslab overlap: stride < block..."));
+		strided |= count[i] > 1 && stride[i] != block[i];
+	}
+	this->dxpl = static_cast<::hid_t>( dxpl ); this->ds = static_cast<::hid_t>( ds );
+	if( ahead.depth ){
+		hsize_t extent[H5CPP_MAX_RANK];
+		h5::sp_t file_space{ H5Dget_space( this->ds ) };
+		H5Sget_simple_extent_dims( static_cast<::hid_t>( file_space ), extent, nullptr );
+		ahead.extent( this->ds, extent );
+	}
+	if( strided )
+		split_to_chunk_strided(filter_direction_t::reverse, offset_.begin(), stride.begin(), block.begin(), count.begin(), ptr );
+	else
+		split_to_chunk_read(filter_direction_t::reverse, offset_.begin(), count_.begin(), ptr );
 }
 
 template< class Derived>
@@ -114,122 +433,376 @@ inline void h5::impl::pipeline_t<Derived>::set_cache( const h5::dcpl_t& dcpl, si
 			throw std::runtime_error("data-space is rank 0, is data space a scalar? ");
 
 	//fix B block/chunk size for the lifespan of pipeline
-	for(int i=0; i<rank; i++ )
-	   	n *= block[i], B[i] = block[rank-i-1];
+	for(hsize_t i=0; i<rank; i++ )
+	   	n *= block[i], B[i] = block[i];
+	select = copy::select( rank );
+	for( auto& e: edge ) e.stamp = 0, e.ptr.reset();
 
 	block_size = n*element_size;
 	unsigned filter_config;
+	if( !filter::is_supported( static_cast<::hid_t>(dcpl) ) )
+		throw h5::error::io::dataset::open( H5CPP_ERROR_MSG("filter chain is not supported by h5cpp pipeline..."));
 	unsigned N = H5Pget_nfilters( dcpl );
-	H5Z_filter_t filter_id;
 	for(unsigned i=0; i<N; i++){
 		cd_size[i] = H5CPP_MAX_FILTER_PARAM;
 		push(
 			filter::get_callback( H5Pget_filter2( dcpl, i, &flags[i], &cd_size[i], cd_values[i], 0, nullptr, &filter_config )));
 	}
 
-	ptr0 = std::move( std::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, block_size )} );
-	ptr1 = std::move( std::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, block_size )} );
+	// aligned_alloc requires size to be multiple of alignment, extra room is for checksums
+	buffer_size = (block_size + 2*H5CPP_MEM_ALIGNMENT - 1) / H5CPP_MEM_ALIGNMENT * H5CPP_MEM_ALIGNMENT;
+	ptr0 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+	ptr1 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+	ahead.reset( buffer_size, block_size, rank, B );
+	cache.reset( buffer_size, block_size, rank );
 	// get an alias to smart ptr
 	if( (chunk0 = ptr0.get()) == NULL || (chunk1 = ptr1.get()) == NULL )
 	   	throw h5::error::io::dataset::open( H5CPP_ERROR_MSG("CTOR: couldn't allocate memory for caching chunks, invalid/check size?"));
 }
 
-#define h5cpp_outer( idx ) for( j##idx =0; j##idx < n##idx; j##idx += b##idx)
-#define h5cpp_inner( idx ) for( i##idx = j##idx; i##idx < std::min(j##idx+b##idx,n##idx); i##idx++)
-#define h5cpp_def( idx ) hsize_t i##idx=0, j##idx = 0, s##idx=0, n##idx=N[idx], b##idx=B[idx], rx##idx=Rx[idx],  ry##idx=Ry[idx];
+template< class Derived>
+inline bool h5::impl::pipeline_t<Derived>::is_contiguous() const {
+	// up to the first dimension -- from the fastest changing -- where chunk is narrower than data the extents must
+	// match, after that chunk must be a single slice 
+	int i = rank - 1;
+	while( i >= 0 && B[i] == N[i] ) i--;
+	for( i--; i >= 0; i-- )
+		if( B[i] != 1 ) return false;
+	return true;
+}
+
+template< class Derived>
+inline int h5::impl::pipeline_t<Derived>::intersect( const hsize_t* g, const hsize_t* O, hsize_t* lo, hsize_t* hi ){
+	int covered = 2;
+	for(hsize_t i=0; i<rank; i++){
+		C[i] = g[i] * B[i];
+		lo[i] = std::max( O[i], C[i] ), hi[i] = std::min( O[i] + N[i], C[i] + B[i] );
+		if( lo[i] > C[i] || hi[i] < std::min( C[i] + B[i], D[i] ) ) covered = 0;
+		else if( hi[i] < C[i] + B[i] && covered ) covered = 1; // past the dataset extent
+	}
+	return covered;
+}
+
+template< class Derived>
+inline void h5::impl::pipeline_t<Derived>::copy_box( char* dst, const hsize_t* dst_dims, const hsize_t* dst_start,
+		const char* src, const hsize_t* src_dims, const hsize_t* src_start, const hsize_t* extent ) const {
+	hsize_t last = rank - 1, dst_stride[H5CPP_MAX_RANK], src_stride[H5CPP_MAX_RANK];
+	dst_stride[last] = src_stride[last] = element_size;
+	for(hsize_t k=last; k>0; k--)
+		dst_stride[k-1] = dst_stride[k] * dst_dims[k], src_stride[k-1] = src_stride[k] * src_dims[k];
+	for(hsize_t k=0; k<rank; k++)
+		dst += dst_start[k] * dst_stride[k], src += src_start[k] * src_stride[k];
+	size_t length = extent[last] * element_size;
+	select( length )( dst, dst_stride, src, src_stride, extent, length );
+}
+
+template< class Derived>
+inline char* h5::impl::pipeline_t<Derived>::fetch_chunk( const hsize_t* offset ){
+	edge_t* slot = edge;
+	for( auto& e: edge ){
+		if( e.stamp && std::equal(offset, offset + rank, e.offset) ){
+			e.stamp = ++clock;
+			return e.ptr.get();
+		}
+		if( e.stamp < slot->stamp ) slot = &e; // least recently used or empty
+	}
+	if( !slot->ptr ) // aligned_alloc requires size to be multiple of alignment
+		slot->ptr = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+	if( !slot->ptr )
+		throw h5::error::io::dataset::write( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+	std::copy(offset, offset + rank, slot->offset);
+	slot->stamp = 0; // until decoded
+	if( !cache.get( offset, slot->ptr.get() ) )
+		read_chunk( offset, block_size, slot->ptr.get() );
+	slot->stamp = ++clock;
+	return slot->ptr.get();
+}
+
+template< class Derived>
+inline void h5::impl::pipeline_t<Derived>::evict_chunk( const hsize_t* offset ){
+	for( auto& e: edge )
+		if( e.stamp && std::equal(offset, offset + rank, e.offset) )
+			e.stamp = 0;
+}
 
 template< class Derived>
 inline void h5::impl::pipeline_t<Derived>::split_to_chunk_read(
-	filter_direction_t direction, const hsize_t* chunk_offset, const hsize_t* dims, void* ptr_ ){
+	filter_direction_t, const hsize_t* O, const hsize_t* dims, void* ptr_ ){
 	char* ptr = static_cast<char*>( ptr_ );
-	// compute edges if any - for the data size
-	// computes R residuals, and sets N dimension in reverse order
-	// when actual data dimensions - current_dims are greater then a chunk, it must be broken into chunk size
-	// if there are residuals on the edges, then padding is needed.
-	unsigned i=0;
-	for(; i<rank; i++ )
-		N[i] = dims[rank-i-1], Ry[i] = N[i] % B[i], Rx[i] = B[i] - chunk_offset[i] % B[i];
-	// set the rest to default
-	for(; i<H5CPP_MAX_RANK; i++) N[i] = B[i] = 1, Rx[i] = Ry[i] = 0;
-
-	// b - block size, j - block index pos, n - actual dimension of data
-	// rx - remainder at the leading edges, ry - remainder at trailing edges 
-	h5cpp_def(0) h5cpp_def(1) h5cpp_def(2) h5cpp_def(3) h5cpp_def(4) h5cpp_def(5) h5cpp_def(6)
-
-	h5cpp_outer( 6 ){ h5cpp_outer( 5 ){ h5cpp_outer( 4 ){ h5cpp_outer( 3 ){
-	h5cpp_outer( 2 ){ h5cpp_outer( 1 ){ h5cpp_outer( 0 ){
-		char* p = chunk0;
-		// at this point we have a single 'chunk' in this->chunk0 buffer ready to go
-		// the coordinates are in j indices
-		D[0] = j0, D[1]=j1, D[2]=j2, D[3]=j3, D[4]=j4, D[5]=j5, D[6]=j6;
-		//coordinates are reversed in D, invert them:
-		for(int k=0;k<rank; k++ ) C[k] = D[rank-k-1] + chunk_offset[k];
-		// execute filters in reverse direction
-		read_chunk( this->C, this->block_size, this->chunk0 );
-
-		h5cpp_inner(6){	h5cpp_inner(5){ h5cpp_inner(4){
-		h5cpp_inner(3){ h5cpp_inner(2){ h5cpp_inner(1){
-			hsize_t offset = i6*n5*n4*n3*n2*n1*n0 + i5*n4*n3*n2*n1*n0 +
-					i4*n3*n2*n1*n0 + i3*n2*n1*n0 + i2*n1*n0 + i1*n0 + j0;
-			if( j0 != n0 - ry0 ) // block copy
-				memcpy(ptr + offset * element_size, p, b0 * element_size );
-			else // edge handling
-				memcpy(ptr + offset * element_size,p, ry0 * element_size );
-			p += b0 * element_size;
-		}}}}}}
-	}}}}}}}
+	hsize_t g[H5CPP_MAX_RANK], first[H5CPP_MAX_RANK], last[H5CPP_MAX_RANK], lo[H5CPP_MAX_RANK], hi[H5CPP_MAX_RANK],
+		   extent[H5CPP_MAX_RANK], at_chunk[H5CPP_MAX_RANK], at_user[H5CPP_MAX_RANK];
+	for(hsize_t i=0; i<rank; i++){
+		if( (N[i] = dims[i]) == 0 ) return;
+		g[i] = first[i] = O[i] / B[i], last[i] = (O[i] + N[i] - 1) / B[i];
+		D[i] = O[i] + N[i]; // read selection must be within dataset extent
+	}
+	bool contiguous = is_contiguous();
+	for(;;){ // chunks touched by selection in row major order
+		if( intersect(g, O, lo, hi) == 2 && contiguous ){ // zero copy: decode into user memory
+			hsize_t offset = 0;
+			for(hsize_t i=0; i<rank; i++) offset = offset * N[i] + lo[i] - O[i];
+			read_through( this->C, ptr + offset * element_size );
+		} else {
+			read_through( this->C, this->chunk0 );
+			for(hsize_t i=0; i<rank; i++)
+				extent[i] = hi[i] - lo[i], at_chunk[i] = lo[i] - C[i], at_user[i] = lo[i] - O[i];
+			copy_box( ptr, N, at_user, chunk0, B, at_chunk, extent );
+		}
+		hsize_t i = rank;
+		while( i > 0 && g[i-1] == last[i-1] ) g[i-1] = first[i-1], i--;
+		if( i == 0 ) return;
+		g[i-1]++;
+	}
 }
 
 template< class Derived>
 inline void h5::impl::pipeline_t<Derived>::split_to_chunk_write(
-	filter_direction_t direction, const hsize_t* chunk_offset, const hsize_t* dims, const void* ptr_ ){
-	const char* ptr = static_cast<const char*>( ptr_ ); const hsize_t* O = chunk_offset;
-	// compute edges if any - for the data size
-	// computes R residuals, and sets N dimension in reverse order
-	// when actual data dimensions - current_dims are greater then a chunk, it must be broken into chunk size
-	// if there are residuals on the edges, then padding is needed.
-	unsigned i=0;
-	for(; i<rank; i++ )
-		N[i] = dims[rank-i-1], Rx[i] = B[i] - O[i] % B[i], Ry[i] = (N[i] - Rx[i]) % B[i];
-	for(; i<H5CPP_MAX_RANK; i++) N[i] = B[i] = 1, Rx[i] = Ry[i] = 0;
-
-	// b - block size, j - block index pos, n - actual dimension of data
-	// rx - remainder at the leading edges, ry - remainder at trailing edges 
-	h5cpp_def(0) h5cpp_def(1) h5cpp_def(2) h5cpp_def(3) h5cpp_def(4) h5cpp_def(5) h5cpp_def(6)
-
-	h5cpp_outer( 6 ){ h5cpp_outer( 5 ){ h5cpp_outer( 4 ){ h5cpp_outer( 3 ){
-	h5cpp_outer( 2 ){ h5cpp_outer( 1 ){ h5cpp_outer( 0 ){
-		char* p = chunk0;
-		// reset memory page only on the edges
-		if( j0 + b0 > n0 || j1 + b1 > n1 || j2 + b2 > n2 ||
-			j3 + b3 > n3 || j4 + b4 > n4 || j5 + b5 > n5 || j6 + b6 > n6 ) memset(p,0x00, block_size);
-
-		h5cpp_inner(6){	h5cpp_inner(5){ h5cpp_inner(4){
-		h5cpp_inner(3){ h5cpp_inner(2){ h5cpp_inner(1){
-			hsize_t offset = i6*n5*n4*n3*n2*n1*n0 + i5*n4*n3*n2*n1*n0 +
-					i4*n3*n2*n1*n0 + i3*n2*n1*n0 + i2*n1*n0 + i1*n0 + j0;
-			if( j0 != n0 - ry0 ) // block copy
-				memcpy(p, ptr + offset * element_size, b0 * element_size );
-			else // trailing edge handling
-				memcpy(p, ptr + offset * element_size, ry0 * element_size );
-			p += b0 * element_size;
-		}}}}}}
-		// at this point we have a single 'chunk' in this->chunk0 buffer ready to go
-		// the coordinates are in j indices
-		D[0] = j0, D[1]=j1, D[2]=j2, D[3]=j3, D[4]=j4, D[5]=j5, D[6]=j6;
-		//coordinates are reversed in D, invert them:
-		for(int k=0;k<rank; k++ ) C[k] = D[rank-k-1] + chunk_offset[k];
-
-		// execute filters in direction
-		write_chunk( this->C, this->block_size, this->chunk0 );
-	}}}}}}}
-}
-#undef h5cpp_def
-#undef h5cpp_inner
-#undef h5cpp_outer
-
-template< class Derived>
-inline void h5::impl::pipeline_t<Derived>::push(filter::call_t filter_){
+	filter_direction_t, const hsize_t* O, const hsize_t* dims, const void* ptr_ ){
+	const char* ptr = static_cast<const char*>( ptr_ );
+	hsize_t g[H5CPP_MAX_RANK], first[H5CPP_MAX_RANK], last[H5CPP_MAX_RANK], lo[H5CPP_MAX_RANK], hi[H5CPP_MAX_RANK],
+		   extent[H5CPP_MAX_RANK], at_chunk[H5CPP_MAX_RANK], at_user[H5CPP_MAX_RANK];
+	for(hsize_t i=0; i<rank; i++){
+		if( (N[i] = dims[i]) == 0 ) return;
+		g[i] = first[i] = O[i] / B[i], last[i] = (O[i] + N[i] - 1) / B[i];
+	}
+	{ // chunks past the dataset extent are padded, the rest of partially covered chunks is preserved 
+		h5::sp_t file_space{ H5Dget_space( ds ) };
+		H5Sget_simple_extent_dims( static_cast<::hid_t>( file_space ), D, nullptr );
+	}
+	bool contiguous = is_contiguous();
+	for(;;){ // chunks touched by selection in row major order
+		int covered = intersect(g, O, lo, hi);
+		if( covered == 2 && contiguous ){ // zero copy: pass user memory to filters or H5Dwrite_chunk
+			hsize_t offset = 0;
+			for(hsize_t i=0; i<rank; i++) offset = offset * N[i] + lo[i] - O[i];
+			evict_chunk( this->C );
+			write_chunk( this->C, this->block_size, ptr + offset * element_size );
+		} else {
+			char* p = chunk0;
+			if( !covered ) // read-modify-write
+				p = fetch_chunk( this->C );
+			else { // chunk is overwritten, only padding must be reset on the edges
+				evict_chunk( this->C );
+				if( covered == 1 ) memset(p, 0x00, block_size);
+			}
+			for(hsize_t i=0; i<rank; i++)
+				extent[i] = hi[i] - lo[i], at_chunk[i] = lo[i] - C[i], at_user[i] = lo[i] - O[i];
+			copy_box( p, B, at_chunk, ptr, N, at_user, extent );
+			write_chunk( this->C, this->block_size, p );
+		}
+		hsize_t i = rank;
+		while( i > 0 && g[i-1] == last[i-1] ) g[i-1] = first[i-1], i--;
+		if( i == 0 ) return;
+		g[i-1]++;
+	}
+}
+
+template< class Derived>
+inline bool h5::impl::pipeline_t<Derived>::select_runs( const hsize_t* g, const hsize_t* O, const hsize_t* S,
+		const hsize_t* K, const hsize_t* Q, int& covered ){
+	covered = 2;
+	for(hsize_t i=0, last = rank - 1; i<rank; i++){
+		C[i] = g[i] * B[i], runs[i].clear();
+		hsize_t lo = C[i], hi = C[i] + B[i], length = 0;
+		// first block ending past the chunk origin, then blocks starting before its end
+		for(hsize_t k = lo >= O[i] + K[i] ? (lo - O[i] - K[i]) / S[i] + 1 : 0; k < Q[i] && O[i] + k*S[i] < hi; k++){
+			hsize_t a = std::max(O[i] + k*S[i], lo), b = std::min(O[i] + k*S[i] + K[i], hi);
+			run_t run{ a - lo, k*K[i] + a - O[i] - k*S[i], b - a };
+			length += run.length;
+			if( i < last ) // outer dimensions are walked one index at a time
+				for(hsize_t j=0; j<run.length; j++) runs[i].push_back( run_t{run.chunk + j, run.user + j, 1} );
+			else if( !runs[i].empty() && runs[i].back().chunk + runs[i].back().length == run.chunk
+					&& runs[i].back().user + runs[i].back().length == run.user )
+				runs[i].back().length += run.length;
+			else runs[i].push_back( run );
+		}
+		if( runs[i].empty() ) return false;
+		if( length < std::min( hi, D[i] ) - lo ) covered = 0;
+		else if( hi > D[i] && covered ) covered = 1;
+	}
+	return true;
+}
+
+template< class Derived>
+inline void h5::impl::pipeline_t<Derived>::split_to_chunk_strided( filter_direction_t direction,
+		const hsize_t* O, const hsize_t* S, const hsize_t* K, const hsize_t* Q, void* ptr_ ){
+	char* ptr = static_cast<char*>( ptr_ );
+	bool writing = direction == filter_direction_t::forward;
+	hsize_t g[H5CPP_MAX_RANK], first[H5CPP_MAX_RANK], last[H5CPP_MAX_RANK], i[H5CPP_MAX_RANK],
+		chunk_stride[H5CPP_MAX_RANK], user_stride[H5CPP_MAX_RANK], inner = rank - 1;
+	for(hsize_t k=0; k<rank; k++){
+		if( (N[k] = Q[k] * K[k]) == 0 ) return;
+		g[k] = first[k] = O[k] / B[k], last[k] = (O[k] + (Q[k] - 1) * S[k] + K[k] - 1) / B[k];
+		D[k] = O[k] + (Q[k] - 1) * S[k] + K[k];
+	}
+	if( writing ){
+		h5::sp_t file_space{ H5Dget_space( ds ) };
+		H5Sget_simple_extent_dims( static_cast<::hid_t>( file_space ), D, nullptr );
+	}
+	chunk_stride[inner] = user_stride[inner] = element_size;
+	for(hsize_t k=inner; k>0; k--)
+		chunk_stride[k-1] = chunk_stride[k] * B[k], user_stride[k-1] = user_stride[k] * N[k];
+	// decimation along the fastest dimension leaves single element runs: use a copy of fixed size
+	void (*copy)(char*, char*, const run_t*, size_t, size_t) = writing ? copy_runs<0,true> : copy_runs<0,false>;
+	if( K[inner] == 1 && (Q[inner] == 1 || S[inner] > 1) ) switch( element_size ){
+		case 1: copy = writing ? copy_runs<1,true> : copy_runs<1,false>; break;
+		case 2: copy = writing ? copy_runs<2,true> : copy_runs<2,false>; break;
+		case 4: copy = writing ? copy_runs<4,true> : copy_runs<4,false>; break;
+		case 8: copy = writing ? copy_runs<8,true> : copy_runs<8,false>; break;
+		case 16: copy = writing ? copy_runs<16,true> : copy_runs<16,false>; break;
+	}
+	for(;;){ // chunks in bounding box of selection in row major order, skipping the ones between blocks
+		int covered;
+		if( select_runs(g, O, S, K, Q, covered) ){
+			char* p = chunk0;
+			if( !writing )
+				read_through( this->C, p );
+			else if( !covered ) // read-modify-write
+				p = fetch_chunk( this->C );
+			else {
+				evict_chunk( this->C );
+				if( covered == 1 ) memset(p, 0x00, block_size);
+			}
+			std::fill(i, i + inner, 0);
+			for(;;){ // rows along the last dimension, odometer over the rest
+				char *chunk = p, *user = ptr;
+				for(hsize_t k=0; k<inner; k++)
+					chunk += runs[k][i[k]].chunk * chunk_stride[k], user += runs[k][i[k]].user * user_stride[k];
+				copy( chunk, user, runs[inner].data(), runs[inner].size(), element_size );
+				hsize_t k = inner;
+				while( k > 0 && ++i[k-1] == runs[k-1].size() ) i[--k] = 0;
+				if( k == 0 ) break;
+			}
+			if( writing ) write_chunk( this->C, this->block_size, p );
+		}
+		hsize_t k = rank;
+		while( k > 0 && g[k-1] == last[k-1] ) g[k-1] = first[k-1], k--;
+		if( k == 0 ) return;
+		g[k-1]++;
+	}
+}
+
+template< class Derived>
+inline const void* h5::impl::pipeline_t<Derived>::encode( void* a, void* b, const void* in, size_t& length, uint32_t& mask ) const {
+	void* buffer[] = {a,b};
+	size_t k = 0; mask = 0;
+	for(hsize_t j=0; j<tail; j++){ // invariant: in == buffer holding result of previous filter
+		size_t nbytes = filter[j].encode(buffer[k % 2], in, length, flags[j], cd_size[j], cd_values[j], buffer_size);
+		if( nbytes == 0 ){ // failure of an optional filter is recorded in filter mask, same as in HDF5 
+			if( !(flags[j] & H5Z_FLAG_OPTIONAL) )
+				throw h5::error::io::dataset::write( H5CPP_ERROR_MSG("mandatory filter failed in chain..."));
+			mask |= 1u << j;
+			continue;
+		}
+		length = nbytes, in = buffer[k++ % 2];
+	}
+	return in;
+}
+
+template< class Derived>
+inline void h5::impl::pipeline_t<Derived>::decode_chunk( const hsize_t* offset, size_t nbytes, void* data){
+	uint32_t mask = 0;
+	hsize_t length = stored_size( ds, offset ); // filter may changed this, think of compression
+	if( length == 0 ){ // chunk not allocated yet: zero, same as default fill value
+		memset(data, 0x00, nbytes);
+		return;
+	}
+	if( tail == 0 ){ // no filters, read directly into destination
+		H5CPP_CHECK_NZ( H5Dread_chunk(ds, dxpl, offset, &mask, data),
+				h5::error::io::dataset::read, h5::error::msg::read_dataset);
+		return;
+	}
+	if( length > buffer_size )
+		throw h5::error::io::dataset::read( H5CPP_ERROR_MSG("stored chunk size exceeds cache, corrupted chunk?"));
+	// reverse filter chain, alternating between buffers such that the last filter writes into `data`,
+	// assuming all filters were applied, which is fixed up once the filter mask is known
+	// when `data` is user memory, the caches hold the intermediate results only
+	bool user = data != chunk0 && data != chunk1;
+	void* buffer[] = {user ? chunk1 : data, data == chunk0 ? chunk1 : chunk0};
+	void* in = buffer[tail % 2];
+	H5CPP_CHECK_NZ( H5Dread_chunk(ds, dxpl, offset, &mask, in),
+			h5::error::io::dataset::read, h5::error::msg::read_dataset);
+	size_t k = 0;
+	for(hsize_t j=0; j<tail; j++)
+		if( !(mask & (1u << j)) ) k++;
+	if( user && k == 0 ) // all optional filters were skipped
+		memcpy(data, in, length);
+	else if( !user && k % 2 != tail % 2 )
+		memcpy(buffer[k % 2], in, length), in = buffer[k % 2];
+	for(hsize_t j=tail; j-- > 0; ){ // invariant: in == buffer holding result of previous filter
+		if( mask & (1u << j) ) continue; // optional filter was skipped when chunk was written
+		bool last = --k == 0;
+		void* out = user && last ? data : in == buffer[0] ? buffer[1] : buffer[0];
+		if( (length = filter[j].decode(out, in, length, flags[j], cd_size[j], cd_values[j],
+						user && last ? nbytes : buffer_size)) == 0 )
+			throw h5::error::io::dataset::read( H5CPP_ERROR_MSG("filter failed in reverse direction, corrupted chunk?"));
+		in = out;
+	}
+}
+
+template< class Derived>
+inline hsize_t h5::impl::pipeline_t<Derived>::stored_size( ::hid_t ds, const hsize_t* offset ){
+	uint32_t mask;
+	haddr_t addr = HADDR_UNDEF;
+	hsize_t length = 0;
+	// H5Dget_chunk_storage_size may report the nominal size of chunks not yet allocated
+	H5CPP_CHECK_NZ( H5Dget_chunk_info_by_coord(ds, offset, &mask, &addr, &length),
+			h5::error::io::dataset::read, h5::error::msg::read_dataset);
+	return addr == HADDR_UNDEF ? 0 : length;
+}
+
+template< class Derived>
+inline herr_t h5::impl::pipeline_t<Derived>::write_raw( ::hid_t ds, ::hid_t dxpl, uint32_t mask, const hsize_t* offset,
+		size_t length, const void* data ){
+	// skipped filters leave the raw size, which HDF5 CAPI may have reached with compression: the mask of a chunk
+	// rewritten with its stored size is kept, so the chunk is written with another size first
+	uint32_t stored_mask; haddr_t addr = HADDR_UNDEF; hsize_t stored = 0;
+	if( mask && length > 1 && H5Dget_chunk_info_by_coord(ds, offset, &stored_mask, &addr, &stored) >= 0
+			&& addr != HADDR_UNDEF && stored == length && stored_mask != mask
+			&& H5Dwrite_chunk(ds, dxpl, mask, offset, length - 1, data) < 0 )
+		return -1;
+	return H5Dwrite_chunk(ds, dxpl, mask, offset, length, data);
+}
+
+template< class Derived>
+inline size_t h5::impl::pipeline_t<Derived>::read_raw( ::hid_t ds, ::hid_t dxpl, const hsize_t* offset,
+		void* raw, uint32_t& mask ) const {
+	hsize_t length = stored_size( ds, offset );
+	if( length == 0 ) return 0;
+	if( length > buffer_size )
+		throw h5::error::io::dataset::read( H5CPP_ERROR_MSG("stored chunk size exceeds cache, corrupted chunk?"));
+	H5CPP_CHECK_NZ( H5Dread_chunk(ds, dxpl, offset, &mask, raw),
+			h5::error::io::dataset::read, h5::error::msg::read_dataset);
+	return length;
+}
+
+template< class Derived>
+inline void h5::impl::pipeline_t<Derived>::decode_raw( void* in, void* tmp, size_t length, uint32_t mask,
+		void* data, size_t nbytes ) const {
+	if( length == 0 ){ // chunk not allocated yet
+		memset(data, 0x00, nbytes);
+		return;
+	}
+	size_t k = 0;
+	for(hsize_t j=0; j<tail; j++)
+		if( !(mask & (1u << j)) ) k++;
+	if( k == 0 ){ // no filters or all were skipped
+		memcpy(data, in, length);
+		return;
+	}
+	void* buffer[] = {in, tmp};
+	for(hsize_t j=tail; j-- > 0; ){
+		if( mask & (1u << j) ) continue;
+		bool last = --k == 0;
+		void* out = last ? data : in == buffer[0] ? buffer[1] : buffer[0];
+		if( (length = filter[j].decode(out, in, length, flags[j], cd_size[j], cd_values[j], last ? nbytes : buffer_size)) == 0 )
+			throw h5::error::io::dataset::read( H5CPP_ERROR_MSG("filter failed in reverse direction, corrupted chunk?"));
+		in = out;
+	}
+}
+
+template< class Derived>
+inline void h5::impl::pipeline_t<Derived>::push(filter::callback_t filter_){
 	filter[tail++] = filter_;
 }
 
@@ -238,4 +811,17 @@ inline void h5::impl::pipeline_t<Derived>::pop(){
 	tail--;
 }
 
+template< class Derived>
+inline void h5::impl::pipeline_t<Derived>::set_scratch( char* a, char* b ){
+	if( a ){
+		ptr0.reset(), ptr1.reset();
+		chunk0 = a, chunk1 = b;
+		return;
+	}
+	ptr0 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+	ptr1 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+	if( (chunk0 = ptr0.get()) == NULL || (chunk1 = ptr1.get()) == NULL )
+		throw h5::error::io::dataset::open( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+}
+
 #endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ *
+ */
+
+#ifndef  H5CPP_PIPELINE_ASYNC_HPP
+#define  H5CPP_PIPELINE_ASYNC_HPP
+
+/* write behind: the caller encodes chunk k+1 into a free slot of the ring while the IO thread writes chunk k
+ * with H5Dwrite_chunk; slots are written in submission order and the caller blocks only when all `depth`
+ * slots are in flight. Memory is bounded by 2 x depth x chunk size. An IO error stops writing, the rest of
+ * the chunks are dropped and the error is rethrown by `flush`, which `pipeline_t::write` calls on return.
+ */
+inline h5::impl::async_pipeline_t::async_pipeline_t( unsigned depth ) :
+	depth( depth ? depth : 2 ), capacity(0), submitted(0), written(0), done(false) {
+}
+
+inline h5::impl::async_pipeline_t::~async_pipeline_t(){
+	try { // dtor must not throw: chunks lost at this point are reported as unrecoverable
+		flush_impl();
+	} catch ( const std::exception& err ){
+		h5::error::io::dataset::rollback( err.what() );
+	}
+	stop();
+}
+
+inline void h5::impl::async_pipeline_t::start(){
+	ring = std::vector<slot_t>( depth );
+	for( auto& slot: ring ){
+		slot.ptr0 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		slot.ptr1 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		if( !slot.ptr0 || !slot.ptr1 ){
+			ring.clear();
+			throw h5::error::io::dataset::write( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+		}
+	}
+	capacity = block_size, done = false;
+	io = std::thread( &async_pipeline_t::writer, this );
+}
+
+inline void h5::impl::async_pipeline_t::stop(){
+	if( !io.joinable() ) return;
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		done = true;
+	}
+	on_submitted.notify_all();
+	io.join();
+	ring.clear(); capacity = 0;
+}
+
+inline void h5::impl::async_pipeline_t::writer(){
+	for(;;){
+		std::unique_lock<std::mutex> lock( mutex );
+		on_submitted.wait( lock, [this]{ return done || written < submitted; } );
+		if( written == submitted ) return;
+		slot_t& slot = ring[ written % ring.size() ];
+		bool skip = error != nullptr;
+		lock.unlock();
+		// once failed, the remaining chunks are dropped until error is picked up by flush
+		if( !skip && write_raw(ds, dxpl, slot.mask, slot.offset, slot.length, slot.out) < 0 ){
+			lock.lock();
+			error = std::make_exception_ptr( h5::error::io::dataset::write( H5CPP_ERROR_MSG("H5Dwrite_chunk failed...")));
+			lock.unlock();
+		}
+		lock.lock();
+		slot.busy = false;
+		written++;
+		lock.unlock();
+		on_written.notify_all();
+	}
+}
+
+inline void h5::impl::async_pipeline_t::write_chunk_impl( const hsize_t* offset, size_t nbytes, const void* data ){
+	if( capacity != block_size ){ // pipeline was reconfigured with `set_cache`
+		flush_impl();
+		stop(); start();
+	}
+	std::unique_lock<std::mutex> lock( mutex );
+	slot_t& slot = ring[ submitted % ring.size() ];
+	on_written.wait( lock, [&slot]{ return !slot.busy; } );
+	lock.unlock();
+
+	// `data` is reused by the caller as soon as we return: the slot must own the bytes written
+	slot.length = nbytes;
+	slot.out = encode( slot.ptr0.get(), slot.ptr1.get(), data, slot.length, slot.mask );
+	if( slot.out == data )
+		slot.out = memcpy( slot.ptr0.get(), data, slot.length );
+	std::copy( offset, offset + rank, slot.offset );
+
+	lock.lock();
+	slot.busy = true;
+	submitted++;
+	lock.unlock();
+	on_submitted.notify_one();
+}
+
+inline void h5::impl::async_pipeline_t::read_chunk_impl( const hsize_t* offset, size_t nbytes, void* data){
+	flush_impl(); // chunk may be still in flight
+	decode_chunk( offset, nbytes, data );
+}
+
+inline void h5::impl::async_pipeline_t::flush_impl(){
+	std::unique_lock<std::mutex> lock( mutex );
+	on_written.wait( lock, [this]{ return written == submitted; } );
+	std::exception_ptr error_ = error;
+	error = nullptr;
+	lock.unlock();
+
+	if( error_ ) try {
+		std::rethrow_exception( error_ );
+	} catch ( const std::exception& err ){
+		throw h5::error::io::dataset::write( err.what() );
+	}
+}
+#endif
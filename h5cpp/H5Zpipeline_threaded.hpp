@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ *
+ */
+
+#ifndef  H5CPP_PIPELINE_THREADED_HPP
+#define  H5CPP_PIPELINE_THREADED_HPP
+
+/* chunks are copied into a ring of 2 x num_threads slots, each slot with its own scratch buffers;
+ * workers run the filter chain on queued slots in any order, while a single IO thread writes encoded
+ * chunks strictly in submission order with H5Dwrite_chunk, therefore HDF5 CAPI is called from one
+ * thread at a time: `pipeline_t::write` returns only after the IO thread drained the ring.
+ */
+inline h5::impl::threaded_pipeline_t::threaded_pipeline_t( unsigned num_threads ) :
+	num_threads( num_threads ? num_threads : std::thread::hardware_concurrency() ),
+	capacity(0), submitted(0), written(0), done(false) {
+	if( this->num_threads == 0 ) this->num_threads = 1;
+}
+
+inline h5::impl::threaded_pipeline_t::~threaded_pipeline_t(){
+	try { // dtor must not throw: chunks lost at this point are reported as unrecoverable
+		flush_impl();
+	} catch ( const std::exception& err ){
+		h5::error::io::dataset::rollback( err.what() );
+	}
+	stop();
+}
+
+inline void h5::impl::threaded_pipeline_t::start(){
+	ring = std::vector<job_t>( 2 * num_threads );
+	for( auto& job: ring ){
+		job.ptr0 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		job.ptr1 = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		if( !job.ptr0 || !job.ptr1 ){
+			ring.clear();
+			throw h5::error::io::dataset::write( H5CPP_ERROR_MSG("couldn't allocate memory for caching chunks..."));
+		}
+	}
+	capacity = block_size, done = false;
+	for( unsigned i=0; i<num_threads; i++ )
+		workers.emplace_back( &threaded_pipeline_t::encoder, this );
+	io = std::thread( &threaded_pipeline_t::writer, this );
+}
+
+inline void h5::impl::threaded_pipeline_t::stop(){
+	if( !io.joinable() ) return;
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		done = true;
+	}
+	on_queued.notify_all(); on_encoded.notify_all();
+	for( auto& worker: workers ) worker.join();
+	io.join();
+	workers.clear(); ring.clear(); capacity = 0;
+}
+
+inline void h5::impl::threaded_pipeline_t::encoder(){
+	for(;;){
+		std::unique_lock<std::mutex> lock( mutex );
+		on_queued.wait( lock, [this]{ return done || !queue.empty(); } );
+		if( queue.empty() ) return;
+		job_t& job = ring[ queue.front() ];
+		queue.pop_front();
+		lock.unlock();
+		try { // data is in ptr1, encode may use it as scratch
+			job.out = encode( job.ptr0.get(), job.ptr1.get(), job.ptr1.get(), job.length, job.mask );
+		} catch ( ... ){
+			lock.lock();
+			if( !error ) error = std::current_exception();
+			lock.unlock();
+			job.length = 0;
+		}
+		lock.lock();
+		job.state = state_t::encoded;
+		lock.unlock();
+		on_encoded.notify_all();
+	}
+}
+
+inline void h5::impl::threaded_pipeline_t::writer(){
+	for(;;){
+		std::unique_lock<std::mutex> lock( mutex );
+		on_encoded.wait( lock, [this]{
+			return (done && written == submitted)
+				|| (written < submitted && ring[ written % ring.size() ].state == state_t::encoded); } );
+		if( written == submitted ) return;
+		job_t& job = ring[ written % ring.size() ];
+		bool skip = error != nullptr;
+		lock.unlock();
+		// once failed, the remaining chunks are dropped until error is picked up by flush
+		if( !skip && write_raw(ds, dxpl, job.mask, job.offset, job.length, job.out) < 0 ){
+			lock.lock();
+			error = std::make_exception_ptr( h5::error::io::dataset::write( H5CPP_ERROR_MSG("H5Dwrite_chunk failed...")));
+			lock.unlock();
+		}
+		lock.lock();
+		job.state = state_t::idle;
+		written++;
+		lock.unlock();
+		on_written.notify_all();
+	}
+}
+
+inline void h5::impl::threaded_pipeline_t::write_chunk_impl( const hsize_t* offset, size_t nbytes, const void* data ){
+	if( tail == 0 ){ // nothing to compute: write directly
+		flush_impl();
+		H5CPP_CHECK_NZ( H5Dwrite_chunk( ds, dxpl, 0x0, offset, nbytes, data),
+				h5::error::io::dataset::write, "H5Dwrite_chunk failed...");
+		return;
+	}
+	if( capacity != block_size ){ // pipeline was reconfigured with `set_cache`
+		flush_impl();
+		stop(); start();
+	}
+	std::unique_lock<std::mutex> lock( mutex );
+	job_t& job = ring[ submitted % ring.size() ];
+	on_written.wait( lock, [&job]{ return job.state == state_t::idle; } );
+	lock.unlock();
+
+	memcpy( job.ptr1.get(), data, nbytes );
+	std::copy( offset, offset + rank, job.offset );
+	job.length = nbytes;
+
+	lock.lock();
+	job.state = state_t::queued;
+	queue.push_back( submitted % ring.size() );
+	submitted++;
+	lock.unlock();
+	on_queued.notify_one();
+}
+
+inline void h5::impl::threaded_pipeline_t::read_chunk_impl( const hsize_t* offset, size_t nbytes, void* data){
+	flush_impl(); // chunk may be still in flight
+	decode_chunk( offset, nbytes, data );
+}
+
+inline void h5::impl::threaded_pipeline_t::flush_impl(){
+	std::unique_lock<std::mutex> lock( mutex );
+	on_written.wait( lock, [this]{ return written == submitted; } );
+	std::exception_ptr error_ = error;
+	error = nullptr;
+	lock.unlock();
+
+	if( error_ ) try {
+		std::rethrow_exception( error_ );
+	} catch ( const std::exception& err ){
+		throw h5::error::io::dataset::write( err.what() );
+	}
+}
+#endif
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ *
+ */
+
+#ifndef  H5CPP_ZPREFETCH_HPP
+#define  H5CPP_ZPREFETCH_HPP
+
+/* chunks are tracked by their row major index in the chunk grid of the dataset; once two consecutive steps
+ * of the highest index seen are the same `delta`, the chunks at index + k x delta, k = 1..depth are scheduled.
+ * Revisiting chunks below the highest index -- frames narrower than chunks -- keeps the pattern, a read
+ * starting before the previous one starts a new scan. The filter chain runs on the background thread; stored bytes
+ * are read there as well when the HDF5 library is thread safe, otherwise by the calling thread at the time of
+ * scheduling, see H5config.hpp.
+ * Chunks behind the current position are evicted, least recently used first; when reads start with the same
+ * chunk as the previous one, the current position is that of the first chunk of the read.
+ * Scheduled reads outlive the call that triggered them, hence are issued with the default transfer properties.
+ */
+inline void h5::impl::read_ahead_t::reset( size_t buffer_size, size_t block_size, hsize_t rank, const hsize_t* B ){
+	stop();
+	this->buffer_size = buffer_size, this->block_size = block_size, this->rank = rank;
+	std::copy(B, B + rank, this->B);
+	chunks = 0, first = 0, last = 0, run = 0, delta = 0, clock = 0, repeat = false;
+}
+
+inline void h5::impl::read_ahead_t::extent( ::hid_t ds, const hsize_t* D ){
+	hsize_t G_[H5CPP_MAX_RANK], chunks_ = 1;
+	for(hsize_t i=0; i<rank; i++)
+		G_[i] = (D[i] + B[i] - 1) / B[i], chunks_ *= G_[i];
+	// index of chunks depends on all but the slowest dimension of the grid
+	if( chunks && (ds != this->ds || !std::equal(G_ + 1, G_ + rank, G + 1)) ) drop();
+	std::copy(G_, G_ + rank, G);
+	chunks = chunks_, begin = true;
+	this->ds = ds;
+}
+
+inline void h5::impl::read_ahead_t::start(){
+	pool = std::vector<slot_t>( depth );
+	for( auto& slot: pool ){
+		slot.raw = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		slot.tmp = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		slot.data = h5::impl::unique_ptr<char>{ (char*)aligned_alloc( H5CPP_MEM_ALIGNMENT, buffer_size )};
+		if( !slot.raw || !slot.tmp || !slot.data ){
+			pool.clear();
+			throw h5::error::io::dataset::read( H5CPP_ERROR_MSG("couldn't allocate memory for read ahead..."));
+		}
+	}
+	done = false;
+	worker = std::thread( &read_ahead_t::loader, this );
+}
+
+inline void h5::impl::read_ahead_t::stop(){
+	if( !worker.joinable() ) return;
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		done = true;
+	}
+	on_pending.notify_all();
+	worker.join();
+	pending.clear(); pool.clear();
+}
+
+inline void h5::impl::read_ahead_t::drop(){
+	first = last = run = delta = 0;
+	std::unique_lock<std::mutex> lock( mutex );
+	pending.clear();
+	on_loaded.wait( lock, [this]{
+		return std::none_of(pool.begin(), pool.end(), [](const slot_t& slot){ return slot.state == state_t::loading; }); } );
+	for( auto& slot: pool ) slot.state = state_t::empty;
+}
+
+inline void h5::impl::read_ahead_t::loader(){
+	for(;;){
+		std::unique_lock<std::mutex> lock( mutex );
+		on_pending.wait( lock, [this]{ return done || !pending.empty(); } );
+		if( done ) return;
+		slot_t* slot = pending.front();
+		pending.pop_front();
+		slot->state = state_t::loading;
+		lock.unlock();
+		state_t state = state_t::ready;
+		try { // errors are reported when the chunk is read again by the caller
+#ifdef H5CPP_HAVE_THREADSAFE_IO
+			slot->length = owner->read_raw( slot->ds, H5P_DEFAULT, slot->offset, slot->raw.get(), slot->mask );
+#endif
+			owner->decode_raw( slot->raw.get(), slot->tmp.get(), slot->length, slot->mask, slot->data.get(), block_size );
+		} catch ( ... ){
+			H5Eclear2( H5E_DEFAULT ); // error stack of this thread would keep the library from closing
+			state = state_t::failed;
+		}
+		lock.lock();
+		slot->state = state;
+		lock.unlock();
+		on_loaded.notify_all();
+	}
+}
+
+inline bool h5::impl::read_ahead_t::issue( hsize_t index, hsize_t current ){
+	if( index >= chunks ) return false;
+	slot_t* victim = nullptr;
+	std::unique_lock<std::mutex> lock( mutex );
+	for( auto& slot: pool ){
+		if( slot.state != state_t::empty && slot.index == index ) return true;
+		if( slot.state == state_t::empty ) slot.stamp = 0;
+		else if( slot.state != state_t::ready && slot.state != state_t::failed ) continue; // in flight
+		else if( slot.index >= current && slot.index < index ) continue; // from the current read on, yet to be read
+		if( !victim || slot.stamp < victim->stamp ) victim = &slot;
+	}
+	if( !victim ) return false;
+	victim->state = state_t::reserved, victim->index = index, victim->stamp = ++clock;
+	victim->ds = ds;
+	lock.unlock();
+	for(hsize_t i=rank, k=index; i-- > 0; k /= G[i])
+		victim->offset[i] = (k % G[i]) * B[i];
+#ifndef H5CPP_HAVE_THREADSAFE_IO
+	try { // the serial library may be called from this thread only
+		victim->length = owner->read_raw( ds, H5P_DEFAULT, victim->offset, victim->raw.get(), victim->mask );
+	} catch ( ... ){
+		lock.lock();
+		victim->state = state_t::empty;
+		return false;
+	}
+#endif
+	lock.lock();
+	victim->state = state_t::queued;
+	pending.push_back( victim );
+	lock.unlock();
+	on_pending.notify_one();
+	return true;
+}
+
+inline bool h5::impl::read_ahead_t::get( const hsize_t* offset, void* data ){
+	if( depth == 0 || chunks == 0 ) return false;
+	hsize_t index = 0;
+	for(hsize_t i=0; i<rank; i++)
+		index = index * G[i] + offset[i] / B[i];
+	if( begin && index < first ) // new scan
+		last = index, run = delta = 0;
+	if( begin ) repeat = index == first, first = index, begin = false;
+	if( index > last ) // same step as before: sequential scan
+		run = index - last == delta ? run + 1 : 0, delta = index - last, last = index;
+	if( !worker.joinable() ) start();
+
+	slot_t* hit = nullptr;
+	std::unique_lock<std::mutex> lock( mutex );
+	for( auto& slot: pool )
+		if( slot.state != state_t::empty && slot.state != state_t::reserved && slot.index == index ){
+			on_loaded.wait( lock, [&slot]{ return slot.state != state_t::queued && slot.state != state_t::loading; } );
+			if( slot.state == state_t::ready ) hit = &slot, slot.stamp = ++clock;
+			else slot.state = state_t::empty;
+			break;
+		}
+	lock.unlock();
+	// ready slots are reused only by this thread
+	if( hit ) memcpy( data, hit->data.get(), block_size ), hits++;
+	else misses++;
+	for(hsize_t k=1; run && k<=depth; k++)
+		if( !issue( last + k * delta, repeat ? first : index ) ) break;
+	return hit != nullptr;
+}
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ *
+ */
+
+#ifndef  H5CPP_ZSHUFFLE_HPP
+#define  H5CPP_ZSHUFFLE_HPP
+
+#ifdef H5CPP_HAVE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+/* HDF5 compatible byte shuffle: byte `j` of element `i` moves to `j*N + i`
+ *
+ * vectorized kernels treat a block of 16 elements of size M = 2^m as a (4+m) bit byte index, where
+ * shuffling is a rotation of the index by 4 bits, unshuffling the inverse rotation by m bits. A round of
+ * `unpacklo|unpackhi_epi8` over vector pairs (p, p + M/2) rotates the index by exactly one bit, hence the
+ * same round is used in both directions. AVX2 lanes carry two independent 16 element blocks.
+ */
+namespace h5 { namespace impl { namespace filter { namespace shuffle_ {
+	inline void shuffle_scalar( unsigned char* out, const unsigned char* in, size_t N, size_t M, size_t first ){
+		for( size_t j=0; j<M; j++ )
+			for( size_t i=first; i<N; i++ )
+				out[j*N + i] = in[i*M + j];
+	}
+	inline void unshuffle_scalar( unsigned char* out, const unsigned char* in, size_t N, size_t M, size_t first ){
+		for( size_t i=first; i<N; i++ )
+			for( size_t j=0; j<M; j++ )
+				out[i*M + j] = in[j*N + i];
+	}
+#ifdef H5CPP_HAVE_X86_SIMD
+	#define H5CPP_UNROLL _Pragma("GCC unroll 16") // loops over registers must be unrolled, also at -O2
+	template <size_t M> constexpr size_t log2(){ return M == 2 ? 1 : M == 4 ? 2 : M == 8 ? 3 : 4; }
+	// kernels process whole blocks starting from element `i`, and return the first element not processed
+
+	// SSE2 is part of x86_64 baseline
+	template <size_t M, size_t R> __attribute__((always_inline)) inline void rounds_sse2( __m128i* v ){
+		__m128i w[M];
+		H5CPP_UNROLL
+		for( size_t r=0; r<R; r++ ){
+			H5CPP_UNROLL
+			for( size_t p=0; p<M/2; p++ )
+				w[2*p] = _mm_unpacklo_epi8( v[p], v[p + M/2] ), w[2*p+1] = _mm_unpackhi_epi8( v[p], v[p + M/2] );
+			H5CPP_UNROLL
+			for( size_t p=0; p<M; p++ ) v[p] = w[p];
+		}
+	}
+	template <size_t M> inline size_t shuffle_sse2( unsigned char* out, const unsigned char* in, size_t N, size_t i ){
+		for( ; i + 16 <= N; i += 16 ){
+			__m128i v[M];
+			H5CPP_UNROLL
+			for( size_t p=0; p<M; p++ )
+				v[p] = _mm_loadu_si128( (const __m128i*)( in + i*M + 16*p ) );
+			rounds_sse2<M,4>( v );
+			H5CPP_UNROLL
+			for( size_t j=0; j<M; j++ )
+				_mm_storeu_si128( (__m128i*)( out + j*N + i ), v[j] );
+		}
+		return i;
+	}
+	template <size_t M> inline size_t unshuffle_sse2( unsigned char* out, const unsigned char* in, size_t N, size_t i ){
+		for( ; i + 16 <= N; i += 16 ){
+			__m128i v[M];
+			H5CPP_UNROLL
+			for( size_t j=0; j<M; j++ )
+				v[j] = _mm_loadu_si128( (const __m128i*)( in + j*N + i ) );
+			rounds_sse2<M,log2<M>()>( v );
+			H5CPP_UNROLL
+			for( size_t p=0; p<M; p++ )
+				_mm_storeu_si128( (__m128i*)( out + i*M + 16*p ), v[p] );
+		}
+		return i;
+	}
+	// AVX2 kernels are compiled for the target regardless of compiler flags, and called only when CPU supports it
+	template <size_t M, size_t R> __attribute__((target("avx2"), always_inline))
+	inline void rounds_avx2( __m256i* v ){
+		__m256i w[M];
+		H5CPP_UNROLL
+		for( size_t r=0; r<R; r++ ){
+			H5CPP_UNROLL
+			for( size_t p=0; p<M/2; p++ )
+				w[2*p] = _mm256_unpacklo_epi8( v[p], v[p + M/2] ), w[2*p+1] = _mm256_unpackhi_epi8( v[p], v[p + M/2] );
+			H5CPP_UNROLL
+			for( size_t p=0; p<M; p++ ) v[p] = w[p];
+		}
+	}
+	template <size_t M> __attribute__((target("avx2")))
+	inline size_t shuffle_avx2( unsigned char* out, const unsigned char* in, size_t N, size_t i ){
+		for( ; i + 32 <= N; i += 32 ){
+			__m256i v[M];
+			H5CPP_UNROLL
+			for( size_t p=0; p<M; p++ ) // elements [i, i+16) in low lane, [i+16,i+32) in high lane
+				v[p] = _mm256_inserti128_si256( _mm256_castsi128_si256(
+							_mm_loadu_si128( (const __m128i*)( in + i*M + 16*p ) )),
+							_mm_loadu_si128( (const __m128i*)( in + (i+16)*M + 16*p ) ), 1 );
+			rounds_avx2<M,4>( v );
+			H5CPP_UNROLL
+			for( size_t j=0; j<M; j++ )
+				_mm256_storeu_si256( (__m256i*)( out + j*N + i ), v[j] );
+		}
+		return i;
+	}
+	template <size_t M> __attribute__((target("avx2")))
+	inline size_t unshuffle_avx2( unsigned char* out, const unsigned char* in, size_t N, size_t i ){
+		for( ; i + 32 <= N; i += 32 ){
+			__m256i v[M];
+			H5CPP_UNROLL
+			for( size_t j=0; j<M; j++ )
+				v[j] = _mm256_loadu_si256( (const __m256i*)( in + j*N + i ) );
+			rounds_avx2<M,log2<M>()>( v );
+			H5CPP_UNROLL
+			for( size_t p=0; p<M; p++ ){
+				_mm_storeu_si128( (__m128i*)( out + i*M + 16*p ), _mm256_castsi256_si128( v[p] ) );
+				_mm_storeu_si128( (__m128i*)( out + (i+16)*M + 16*p ), _mm256_extracti128_si256( v[p], 1 ) );
+			}
+		}
+		return i;
+	}
+	inline bool has_avx2(){
+		static const bool value = ( __builtin_cpu_init(), __builtin_cpu_supports("avx2") );
+		return value;
+	}
+	template <size_t M> inline void shuffle( unsigned char* out, const unsigned char* in, size_t N ){
+		size_t i = has_avx2() ? shuffle_avx2<M>( out, in, N, 0 ) : 0;
+		shuffle_scalar( out, in, N, M, shuffle_sse2<M>( out, in, N, i ) );
+	}
+	template <size_t M> inline void unshuffle( unsigned char* out, const unsigned char* in, size_t N ){
+		size_t i = has_avx2() ? unshuffle_avx2<M>( out, in, N, 0 ) : 0;
+		unshuffle_scalar( out, in, N, M, unshuffle_sse2<M>( out, in, N, i ) );
+	}
+#endif
+	// dispatches on element size `M`, then on CPU features
+	inline void shuffle( unsigned char* out, const unsigned char* in, size_t N, size_t M ){
+		switch( M ){
+#ifdef H5CPP_HAVE_X86_SIMD
+			case 2: shuffle<2>( out, in, N ); break;
+			case 4: shuffle<4>( out, in, N ); break;
+			case 8: shuffle<8>( out, in, N ); break;
+			case 16: shuffle<16>( out, in, N ); break;
+#endif
+			default: shuffle_scalar( out, in, N, M, 0 );
+		}
+	}
+	inline void unshuffle( unsigned char* out, const unsigned char* in, size_t N, size_t M ){
+		switch( M ){
+#ifdef H5CPP_HAVE_X86_SIMD
+			case 2: unshuffle<2>( out, in, N ); break;
+			case 4: unshuffle<4>( out, in, N ); break;
+			case 8: unshuffle<8>( out, in, N ); break;
+			case 16: unshuffle<16>( out, in, N ); break;
+#endif
+			default: unshuffle_scalar( out, in, N, M, 0 );
+		}
+	}
+}}}}
+#undef H5CPP_UNROLL
+#endif
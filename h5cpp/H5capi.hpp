@@ -10,20 +10,6 @@
 /* rules:
  * h5::id_t{ hid_t } or direct initialization  doesn't increment reference count
  */ 
-namespace h5 { namespace impl {
-	struct free {
-		template <typename T>
-		void operator()(T *p) const {
-			using T_ = typename std::remove_const<T>::type;
-			std::free( const_cast<T_*>(p) );
-		}
-	};
-
-	template <typename T>
-		using unique_ptr = std::unique_ptr<T,h5::impl::free>;
-}}
-
-
 namespace h5 {
 	inline ::hid_t get_access_plist( const ds_t& ds ){
 		return ds.dapl;
@@ -155,13 +141,90 @@ namespace h5 {
 				H5Sselect_hyperslab( static_cast<hid_t>(sp), H5S_SELECT_SET, *offset, *stride, *count, *block),
 			   std::runtime_error,	h5::error::msg::select_hyperslab);
 	}
+}
+
+namespace h5 { namespace impl {
+	struct dictionary_t; // see H5Dstring.hpp
+	/* properties of dataset queried on the first IO call through a descriptor, instead of on each call: many small
+	 * reads and writes are dominated by H5Dget_space, H5Pexist, ... otherwise. The extent is kept only for
+	 * contiguous and compact datasets, which can't be resized; of chunked and virtual ones it may be changed through
+	 * any descriptor or process, and is read again on each call so that HDF5 checks selections against it.
+	 */
+	struct ds_meta_t {
+		ds_meta_t( const h5::ds_t& ds );
+		// file space with hyperslab selected
+		const h5::sp_t& select( const h5::ds_t& ds, const h5::offset_t& offset, const h5::stride_t& stride,
+				const h5::count_t& count, const h5::block_t& block );
+		// memory space of `size`, kept while calls are of the same shape
+		const h5::sp_t& memory( const h5::count_t& size );
+
+		// element type is queried on first use
+		const h5::dt_t<void*>& type( const h5::ds_t& ds );
+
+		int rank;
+		impl::pipeline_base_t* pipeline; // carried by dapl, or nullptr
+		bool extent; // file_space is up to date, reset by h5::set_extent
+		bool fixed; // extent can't change, see above
+		std::shared_ptr<impl::dictionary_t> dictionary; // of dictionary encoded strings, loaded on first use
+
+		private:
+		h5::sp_t file_space, mem_space;
+		h5::count_t mem_dims;
+		h5::dt_t<void*> type_;
+	};
+
+	inline ds_meta_t& get_meta( const h5::ds_t& ds ){
+		if( !ds.meta ) ds.meta = std::make_shared<ds_meta_t>( ds );
+		return *ds.meta;
+	}
+}}
+
+inline h5::impl::ds_meta_t::ds_meta_t( const h5::ds_t& ds ) :
+	pipeline( impl::get_pipeline( ds.dapl ) ), extent( true ), file_space( h5::get_space( ds ) ) {
+	h5::current_dims_t current_dims;
+	rank = h5::get_simple_extent_dims( file_space, current_dims );
+	h5::dcpl_t dcpl = h5::get_dcpl( ds );
+	H5D_layout_t layout = H5Pget_layout( static_cast<::hid_t>( dcpl ) );
+	fixed = layout == H5D_CONTIGUOUS || layout == H5D_COMPACT;
+	mem_dims.rank = -1;
+}
+
+inline const h5::dt_t<void*>& h5::impl::ds_meta_t::type( const h5::ds_t& ds ){
+	if( static_cast<::hid_t>( type_ ) < 0 ) type_ = h5::get_type<void*>( ds );
+	return type_;
+}
+
+inline const h5::sp_t& h5::impl::ds_meta_t::select( const h5::ds_t& ds, const h5::offset_t& offset,
+		const h5::stride_t& stride, const h5::count_t& count, const h5::block_t& block ){
+	if( !extent || !fixed ){
+		file_space = h5::get_space( ds );
+		extent = true;
+	}
+	h5::select_hyperslab( file_space, offset, stride, count, block );
+	return file_space;
+}
+
+inline const h5::sp_t& h5::impl::ds_meta_t::memory( const h5::count_t& size ){
+	bool same = mem_dims.rank == size.rank;
+	for( int i=0; same && i<size.rank; i++ ) same = mem_dims[i] == size[i];
+	if( !same ){
+		mem_space = h5::create_simple( size );
+		mem_dims.rank = size.rank;
+		for( int i=0; i<size.rank; i++ ) mem_dims[i] = size[i];
+	}
+	return mem_space;
+}
+
+namespace h5 {
 	inline void set_extent(const h5::ds_t& ds, const h5::current_dims_t& dims ){
 		H5CPP_CHECK_NZ(
 				H5Dset_extent( static_cast<hid_t>(ds), *dims ),std::runtime_error,	 h5::error::msg::set_extent);
+		if( ds.meta ) ds.meta->extent = false;
 	}
 	inline void set_extent(const h5::ds_t& ds, const hsize_t* dims ){
 		H5CPP_CHECK_NZ(
 				H5Dset_extent( static_cast<hid_t>(ds), dims ),std::runtime_error,	 h5::error::msg::set_extent);
+		if( ds.meta ) ds.meta->extent = false;
 	}
 	template <class T>
 	inline void writeds(const h5::ds_t& ds,
@@ -184,25 +247,9 @@ namespace h5 {
 		H5CPP_CHECK_NZ(( ds = H5Dcreate2( static_cast<hid_t>(fd), path.data(), type, static_cast<hid_t>(sp),
 								static_cast<hid_t>(lcpl), static_cast<hid_t>(dcpl), static_cast<hid_t>( dapl )  )),
 			   std::runtime_error,	h5::error::msg::create_dataset );
-		//FIXME: hack to carry prop over
+		// carry high throughput pipeline along, see H5Pdapl.hpp
 		h5::ds_t ds_{ds};
-
-		switch( H5Pget_layout(static_cast<::hid_t>( dcpl)) ){
-			case H5D_COMPACT: break;
-			case H5D_CONTIGUOUS: break;
-			case H5D_CHUNKED:
-				if( H5Pexist(dapl, H5CPP_DAPL_HIGH_THROUGPUT) ){
-					// grab pointer to uninitialized pipeline
-					h5::impl::pipeline_t<impl::basic_pipeline_t>* ptr;
-					H5Pget(dapl, H5CPP_DAPL_HIGH_THROUGPUT, &ptr);
-					hid_t type_id = H5Dget_type( static_cast<::hid_t>(ds) );
-					size_t element_size = H5Tget_size( type_id );
-					ptr->set_cache(dcpl, element_size);
-				}
-				break;
-			case H5D_VIRTUAL: break;
-		}
-		ds_.dapl = static_cast<::hid_t>( dapl );
+		ds_.dapl = h5::impl::dapl_pipeline_open( ds, static_cast<::hid_t>( dapl ) );
 		return ds_;
 	}
 
@@ -23,6 +23,16 @@
 #ifndef H5CPP_MAX_FILTER_PARAM
 	#define H5CPP_MAX_FILTER_PARAM 16 //< maximum number of filters in a chain
 #endif
+// background threads of h5cpp pipelines call HDF5 CAPI only if the library is thread safe
+#if defined(H5_HAVE_THREADSAFE) && !defined(H5CPP_NO_THREADSAFE_IO)
+	#define H5CPP_HAVE_THREADSAFE_IO
+#endif
+#ifndef H5CPP_SHORT_ROW
+	#define H5CPP_SHORT_ROW 256 //< rows of chunk copies up to this many bytes are moved in words instead of memcpy
+#endif
+#ifndef H5CPP_MAX_EDGE_CHUNK
+	#define H5CPP_MAX_EDGE_CHUNK 8 //< partially written chunks kept decoded for read-modify-write
+#endif
 #ifndef H5CPP_MEM_ALIGNMENT
 	#define H5CPP_MEM_ALIGNMENT 64 //< maximum number of filters in a chain
 #endif
@@ -43,6 +53,11 @@
 	#define H5CPP_RANK_CUBE 3
 #endif
 
+// vectorized filters with runtime CPU dispatch on x86_64, `-DH5CPP_SIMD_DISABLED` to disable
+#if !defined(H5CPP_SIMD_DISABLED) && defined(__GNUC__) && defined(__x86_64__)
+	#define H5CPP_HAVE_X86_SIMD
+#endif
+
 // implicit conversion enabled by default `-DH5CPP_CONVERSION_EXPLICIT` to disable 
 #ifndef H5CPP_CONVERSION_EXPLICIT
 	#define H5CPP_CONVERSION_IMPLICIT
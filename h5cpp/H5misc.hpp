@@ -6,6 +6,73 @@
 
 #ifndef  H5CPP_MISC_HPP
 #define  H5CPP_MISC_HPP
+namespace h5 { namespace impl {
+	struct free {
+		template <typename T>
+		void operator()(T *p) const {
+			using T_ = typename std::remove_const<T>::type;
+			std::free( const_cast<T_*>(p) );
+		}
+	};
+
+	template <typename T>
+		using unique_ptr = std::unique_ptr<T,h5::impl::free>;
+}}
+
+namespace h5 {
+	/* bump allocator owning variable length data read with it, see h5::read( ds, arena, ... ): memory is 8 byte aligned
+	 * and given back all at once. Blocks grow geometrically, clear() keeps a single block large enough for what
+	 * was allocated so far: repeated reads of the same size allocate no memory once warm.
+	 */
+	struct arena_t {
+		arena_t( size_t block_size = 1<<16 ) : block_size( block_size ) {}
+		arena_t( const arena_t& ) = delete;
+		arena_t& operator=( const arena_t& ) = delete;
+		arena_t( arena_t&& ) = default;
+		arena_t& operator=( arena_t&& ) = default;
+
+		// nullptr when out of memory
+		void* allocate( size_t size );
+		// data allocated so far is released
+		void clear();
+		// bytes allocated, and held by arena
+		size_t size() const { size_t n = 0; for( auto& block: blocks ) n += block.used; return n; }
+		size_t capacity() const { size_t n = 0; for( auto& block: blocks ) n += block.size; return n; }
+
+		private:
+		struct block_t {
+			h5::impl::unique_ptr<char> ptr;
+			size_t size, used;
+		};
+		std::vector<block_t> blocks;
+		size_t block_size;
+	};
+}
+
+inline void* h5::arena_t::allocate( size_t size ){
+	size = (size + 7) & ~size_t(7);
+	if( blocks.empty() || blocks.back().used + size > blocks.back().size ){
+		size_t n = std::max( size, blocks.empty() ? block_size : 2 * blocks.back().size );
+		h5::impl::unique_ptr<char> ptr{ static_cast<char*>( std::malloc( n ) ) };
+		if( !ptr ) return nullptr;
+		blocks.push_back( block_t{ std::move( ptr ), n, 0 } );
+	}
+	block_t& block = blocks.back();
+	void* ptr = block.ptr.get() + block.used;
+	block.used += size;
+	return ptr;
+}
+
+inline void h5::arena_t::clear(){
+	if( blocks.size() > 1 ){ // merged into one
+		size_t n = capacity();
+		blocks.clear();
+		h5::impl::unique_ptr<char> ptr{ static_cast<char*>( std::malloc( n ) ) };
+		if( ptr ) blocks.push_back( block_t{ std::move( ptr ), n, 0 } );
+	}
+	for( auto& block: blocks ) block.used = 0;
+}
+
 namespace h5{
 	using cx_double =  std::complex<double>; /**< scientific type */
 	using cx_float = std::complex<float>;    /**< scientific type */
@@ -44,6 +44,26 @@ int main(int argc, char **argv) {
 		std::cout << sizeof(sn::struct_type) <<"\n";
 	}
 	ProfilerStop();
+	{ // small reads of a compound dataset: the type descriptor is built once and shared by each call,
+	  // instead of a compound type tree built and released per call
+		h5::ds_t ds = h5::create<sn::struct_type>(fd, "small reads", h5::current_dims{1024} );
+		h5::write(ds, static_cast<const sn::struct_type*>( ptr ), h5::count{1024} );
+		long long calls = 100'000ll;
+		timer.tic();
+		for(long long i=0; i<calls; i++)
+			H5Tclose( h5::register_struct<sn::struct_type>() );
+		double rebuilt = timer.toc() / calls * 1e6;
+		timer.tic();
+		for(long long i=0; i<calls; i++)
+			h5::dt_t<sn::struct_type> type;
+		double cached = timer.toc() / calls * 1e6;
+		timer.tic();
+		for(long long i=0; i<calls; i++)
+			h5::read(ds, &data, h5::offset{hsize_t(i % 1024)}, h5::count{1} );
+		double read = timer.toc() / calls * 1e6;
+		std::cout << "type id per call  built: " << rebuilt << "us cached: " << cached << "us\n"
+			<< "single record read: " << read << "us, " << rebuilt << "us more with type built per call\n";
+	}
 	free(ptr);
 }
 
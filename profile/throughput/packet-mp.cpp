@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <h5cpp/core>
+
+namespace SomeNameSpace {
+	struct tick {
+		unsigned long stock;
+		double time_stamp;
+		float ask_price;
+		float bid_price;
+	};
+}
+namespace sn = SomeNameSpace;
+namespace h5{
+	template<> hid_t inline register_struct<sn::tick>(){
+		hid_t type = H5Tcreate(H5T_COMPOUND, sizeof (sn::tick));
+		H5Tinsert(type, "stock", 		HOFFSET(sn::tick, stock),       H5T_NATIVE_ULONG);
+		H5Tinsert(type, "time_stamp", 	HOFFSET(sn::tick, time_stamp),  H5T_NATIVE_DOUBLE);
+		H5Tinsert(type, "ask_price", 	HOFFSET(sn::tick, ask_price),   H5T_NATIVE_FLOAT);
+		H5Tinsert(type, "bid_price", 	HOFFSET(sn::tick, bid_price),   H5T_NATIVE_FLOAT);
+		return type;
+	}
+}
+H5CPP_REGISTER_STRUCT(sn::tick);
+#include <h5cpp/io>
+
+/* feed handler: `threads` producers appending ticks to the same dataset, through a mutex guarded h5::pt_t
+ * then through h5::mpt_t, where slots of the chunk are reserved with an atomic cursor
+ * usage: ./packet-mp [threads] [records per thread]
+ */
+template <class F> double run( unsigned threads, F&& producer ){
+	std::vector<std::thread> pool;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for( unsigned i=0; i<threads; i++ )
+		pool.emplace_back( producer, i );
+	for( auto& t : pool ) t.join();
+	return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+int main(int argc, char **argv) {
+	unsigned threads = argc > 1 ? std::stoul( argv[1] ) : 8;
+	long long size = argc > 2 ? std::stoll( argv[2] ) : 2'000'000ll;
+	h5::fd_t fd = h5::create("packet-mp.h5",H5F_ACC_TRUNC );
+	auto report = [&]( const char* name, double running_time ){
+		double rate = threads * size / running_time;
+		std::cout << name << ": " << running_time << "s record per sec: " << rate
+			<< " sustained throughput: " << rate * sizeof(sn::tick) / 1'000'000 << " Mbyte/sec\n";
+	};
+	std::cout << "producers: " << threads << " records per producer: " << size << "\n";
+	{
+		h5::pt_t pt = h5::create<sn::tick>(fd, "mutex", h5::max_dims{H5S_UNLIMITED},
+				h5::chunk{4096} | h5::gzip{1}, h5::async_write{2} );
+		std::mutex mutex;
+		report("mutex + h5::pt_t", run( threads, [&]( unsigned id ){
+			sn::tick data{id, 0.0, 1.0f, 2.0f};
+			for( long long i=0; i<size; i++ ){
+				data.time_stamp = i;
+				std::lock_guard<std::mutex> lock( mutex );
+				h5::append(pt, data);
+			}
+		}));
+	}
+	{
+		h5::mpt_t pt = h5::create<sn::tick>(fd, "atomic", h5::max_dims{H5S_UNLIMITED},
+				h5::chunk{4096} | h5::gzip{1}, h5::async_write{2} );
+		report("h5::mpt_t", run( threads, [&]( unsigned id ){
+			sn::tick data{id, 0.0, 1.0f, 2.0f};
+			for( long long i=0; i<size; i++ ){
+				data.time_stamp = i;
+				h5::append(pt, data);
+			}
+		}));
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <h5cpp/core>
+
+namespace SomeNameSpace {
+	struct tick {
+		unsigned long stock;
+		double time_stamp;
+		float ask_price;
+		float bid_price;
+		long long written; // steady clock of writer, ns
+	};
+}
+namespace sn = SomeNameSpace;
+namespace h5{
+	template<> hid_t inline register_struct<sn::tick>(){
+		hid_t type = H5Tcreate(H5T_COMPOUND, sizeof (sn::tick));
+		H5Tinsert(type, "stock", 		HOFFSET(sn::tick, stock),       H5T_NATIVE_ULONG);
+		H5Tinsert(type, "time_stamp", 	HOFFSET(sn::tick, time_stamp),  H5T_NATIVE_DOUBLE);
+		H5Tinsert(type, "ask_price", 	HOFFSET(sn::tick, ask_price),   H5T_NATIVE_FLOAT);
+		H5Tinsert(type, "bid_price", 	HOFFSET(sn::tick, bid_price),   H5T_NATIVE_FLOAT);
+		H5Tinsert(type, "written", 		HOFFSET(sn::tick, written),     H5T_NATIVE_LLONG);
+		return type;
+	}
+}
+H5CPP_REGISTER_STRUCT(sn::tick);
+#include <h5cpp/io>
+
+/* writer to reader latency of a packet table in SWMR mode: the writer appends `rate` ticks per second stamped
+ * with the steady clock -- system wide on linux -- flushing every `records` or `ms` milliseconds, while a reader
+ * process tails the file with h5::pt_tail and measures the age of each tick when it is first seen
+ * usage: ./packet-swmr [records] [ms] [rate] [seconds]
+ */
+long long now(){
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+int reader( long long size ){
+	h5::fd_t fd = h5::open("packet-swmr.h5", H5F_ACC_RDONLY | H5F_ACC_SWMR_READ, h5::latest_version);
+	h5::pt_tail<sn::tick> ticks = h5::open(fd, "ticks");
+	std::vector<sn::tick> batch;
+	std::vector<double> latency;
+	size_t polls = 0;
+	while( ticks.position() < size ){
+		batch.clear();
+		polls++;
+		if( !ticks.poll( batch ) ){
+			std::this_thread::sleep_for( std::chrono::microseconds(100) );
+			continue;
+		}
+		long long seen = now();
+		for( auto& tick : batch )
+			latency.push_back( (seen - tick.written) / 1e3 );
+	}
+	std::sort( latency.begin(), latency.end() );
+	auto at = [&]( double q ){ return latency[ std::min( latency.size() - 1, size_t(q * latency.size()) ) ]; };
+	std::cout << "ticks: " << latency.size() << " polls: " << polls << "\n"
+		<< "latency us  p50: " << at(.5) << " p90: " << at(.9) << " p99: " << at(.99) << " max: " << latency.back() << "\n";
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	hsize_t records = argc > 1 ? std::stoull( argv[1] ) : 1000;
+	unsigned ms = argc > 2 ? std::stoul( argv[2] ) : 10;
+	long long rate = argc > 3 ? std::stoll( argv[3] ) : 100'000ll;
+	long long seconds = argc > 4 ? std::stoll( argv[4] ) : 5;
+	long long size = rate * seconds;
+	if( argc > 5 ) return reader( size );
+
+	{ // objects are created before switching to SWMR mode
+		h5::fd_t fd = h5::create("packet-swmr.h5", H5F_ACC_TRUNC, h5::default_fcpl, h5::latest_version);
+		h5::create<sn::tick>(fd, "ticks", h5::max_dims{H5S_UNLIMITED}, h5::chunk{4096} | h5::gzip{1} );
+	}
+	h5::fd_t fd = h5::open("packet-swmr.h5", H5F_ACC_RDWR | H5F_ACC_SWMR_WRITE, h5::latest_version);
+	std::cout << "flush every " << records << " records or " << ms << "ms, " << rate << " ticks per sec" << std::endl;
+	pid_t pid = fork(); // reader is a process of its own: HDF5 state is not shared
+	if( pid == 0 ){
+		execl( argv[0], argv[0], std::to_string( records ).data(), std::to_string( ms ).data(),
+				std::to_string( rate ).data(), std::to_string( seconds ).data(), "reader", (char*)nullptr );
+		_exit(1);
+	}
+	{
+		h5::pt_t pt = h5::open(fd, "ticks", h5::swmr_flush({records, ms}) );
+		long long start = now(), period = 1'000'000'000ll / rate;
+		for( long long i=0; i<size; i++ ){
+			while( now() < start + i * period );
+			h5::append(pt, sn::tick{ 1, double(i), 1.0f, 2.0f, now() });
+		}
+	}
+	int status;
+	waitpid( pid, &status, 0 );
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2018 vargaconsulting, Toronto,ON Canada
+ * Author: Varga, Steven <steven@vargaconsulting.ca>
+ */
+
+#include <vector>
+#include <chrono>
+#include <h5cpp/all>
+
+/* variable length string column: strings copied with strdup before writing and read with a heap allocation each,
+ * against c_str() pointers passed as they are and reads into a single arena block; then storage and speed of
+ * the same column as fixed length and dictionary encoded strings
+ * usage: ./string-vl [strings]
+ */
+struct stopwatch {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	double operator()() const { return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count(); }
+};
+
+int main(int argc, char **argv) {
+	size_t size = argc > 1 ? std::stoull( argv[1] ) : 1'000'000;
+	std::vector<std::string> symbols( size );
+	for( size_t i=0; i<size; i++ ) // tickers of 3 to 12 characters
+		symbols[i] = std::string( 3 + i % 10, 'A' + i % 26 );
+
+	h5::fd_t fd = h5::create("string-vl.h5", H5F_ACC_TRUNC);
+	// each write to a dataset of its own: overwriting variable length data is much slower than writing it
+	h5::ds_t ds = h5::create<char*>(fd, "symbols", h5::current_dims{size}, h5::chunk{64*1024} | h5::gzip{1} );
+	h5::ds_t copy = h5::create<char*>(fd, "strdup", h5::current_dims{size}, h5::chunk{64*1024} | h5::gzip{1} );
+	h5::dt_t<char*> type;
+	std::cout << size << " strings\n";
+	{ // strdup each
+		stopwatch timer;
+		std::vector<char*> ptr;
+		for( const auto& symbol : symbols ) ptr.push_back( strdup( symbol.data() ) );
+		H5Dwrite( static_cast<hid_t>( copy ), static_cast<hid_t>( type ), H5S_ALL, H5S_ALL, H5P_DEFAULT, ptr.data() );
+		for( auto p : ptr ) free( p );
+		std::cout << "write  strdup: " << timer() << "s\n";
+	}
+	{
+		stopwatch timer;
+		h5::write( ds, symbols );
+		std::cout << "write  c_str:  " << timer() << "s\n";
+	}
+	{ // malloc each
+		stopwatch timer;
+		std::vector<char*> ptr( size );
+		H5Dread( static_cast<hid_t>( ds ), static_cast<hid_t>( type ), H5S_ALL, H5S_ALL, H5P_DEFAULT, ptr.data() );
+		std::vector<std::string> strings( ptr.begin(), ptr.end() );
+		h5::sp_t space = h5::get_space( ds );
+		H5Dvlen_reclaim( static_cast<hid_t>( type ), static_cast<hid_t>( space ), H5P_DEFAULT, ptr.data() );
+		std::cout << "read   malloc: " << timer() << "s\n";
+	}
+	h5::arena_t arena;
+	for( int i=0; i<2; i++ ){ // second read reuses block of the first
+		stopwatch timer;
+		std::vector<std::string_view> strings = h5::read( ds, arena );
+		std::cout << "read   arena:  " << timer() << "s " << arena.size() << " of " << arena.capacity() << " bytes\n";
+		arena.clear();
+	}
+	{
+		stopwatch timer;
+		auto strings = h5::read<std::vector<std::string>>( ds );
+		std::cout << "read   string: " << timer() << "s\n";
+	}
+	std::cout << "\nvariable length: " << H5Dget_storage_size( static_cast<hid_t>( ds ) ) << " bytes + global heap\n";
+	for( auto path : {"fixed", "dictionary"} ){
+		stopwatch timer;
+		h5::ds_t column = std::string( path ) == "fixed"
+			? h5::write( fd, path, symbols, h5::fixed_length{0}, h5::chunk{64*1024} | h5::gzip{1} )
+			: h5::write( fd, path, symbols, h5::dictionary, h5::chunk{64*1024} | h5::gzip{1} );
+		double write = timer();
+		timer = stopwatch();
+		auto strings = h5::read<std::vector<std::string>>( column );
+		std::cout << path << ": " << H5Dget_storage_size( static_cast<hid_t>( column ) ) << " bytes"
+			<< " write: " << write << "s read: " << timer() << "s\n";
+	}
+}
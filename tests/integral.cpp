@@ -195,6 +195,103 @@ TYPED_TEST(IntegralTest, read_simple) {
 
 }
 
+TYPED_TEST(IntegralTest, small_io_meta_cache) {
+	// spaces and type of descriptor are built on first call, then reused by calls of the same and other shapes
+	h5::ds_t ds = h5::create<TypeParam>(this->fd, this->name + "small io", h5::current_dims{100} );
+	for( int i=0; i<100; i++ ){
+		const TypeParam value = i;
+		h5::write(ds, &value, h5::count{1}, h5::offset{hsize_t(i)} );
+	}
+	TypeParam pair[2];
+	for( int i=0; i<98; i++ ){
+		TypeParam value;
+		h5::read(ds, &value, h5::count{1}, h5::offset{hsize_t(i)} );
+		ASSERT_EQ( value, i );
+		h5::read(ds, pair, h5::count{2}, h5::offset{hsize_t(i + 1)} );
+		ASSERT_EQ( pair[0], i + 1 ); ASSERT_EQ( pair[1], i + 2 );
+	}
+	// the same through the extent of a contiguous dataset, which is kept
+	TypeParam past[5];
+	EXPECT_THROW( h5::read(ds, past, h5::count{5}, h5::offset{98} ), h5::error::io::dataset::read );
+}
+
+TYPED_TEST(IntegralTest, meta_cache_extent) {
+	std::vector<TypeParam> data(20), buf(5);
+	for( int i=0; i<20; i++ ) data[i] = i + 1;
+	const TypeParam* ptr = data.data();
+	h5::ds_t a = h5::create<TypeParam>(this->fd, this->name + "extent", h5::current_dims{20},
+			h5::max_dims{H5S_UNLIMITED}, h5::chunk{5} );
+	h5::write(a, ptr, h5::count{20} );
+	h5::ds_t b = h5::open(this->fd, this->name + "extent");
+	h5::read(b, buf.data(), h5::count{5}, h5::offset{12} );
+	ASSERT_EQ( buf[0], 13 );
+
+	// shrunk through another descriptor: selections past the extent fail instead of returning zeros
+	h5::set_extent(b, h5::current_dims{10} );
+	EXPECT_THROW( h5::read(a, buf.data(), h5::count{5}, h5::offset{12} ), h5::error::io::dataset::read );
+	EXPECT_THROW( h5::write(a, ptr, h5::count{5}, h5::offset{12} ), h5::error::io::dataset::write );
+	h5::read(a, buf.data(), h5::count{5}, h5::offset{5} );
+	ASSERT_EQ( buf[4], 10 );
+	// grown through another descriptor
+	h5::set_extent(b, h5::current_dims{30} );
+	h5::write(a, ptr, h5::count{5}, h5::offset{25} );
+	h5::read(b, buf.data(), h5::count{5}, h5::offset{25} );
+	ASSERT_EQ( buf[0], 1 ); ASSERT_EQ( buf[4], 5 );
+
+	// set_extent on the same descriptor
+	h5::set_extent(a, h5::current_dims{40} );
+	h5::write(a, ptr, h5::count{5}, h5::offset{35} );
+	h5::read(a, buf.data(), h5::count{5}, h5::offset{35} );
+	ASSERT_EQ( buf[4], 5 );
+	h5::set_extent(a, h5::current_dims{8} );
+	EXPECT_THROW( h5::read(a, buf.data(), h5::count{5}, h5::offset{5} ), h5::error::io::dataset::read );
+	h5::read(a, buf.data(), h5::count{5}, h5::offset{3} );
+	ASSERT_EQ( buf[0], 4 );
+}
+
+TYPED_TEST(IntegralTest, ds_cache) {
+	std::vector<TypeParam> data(10, 1), buf(10);
+	const TypeParam* ptr = data.data();
+	std::string path[3];
+	for( int i=0; i<3; i++ ){
+		path[i] = this->name + "ds cache " + std::to_string(i);
+		h5::ds_t ds = h5::create<TypeParam>(this->fd, path[i], h5::current_dims{10}, h5::chunk{5} | h5::gzip{1} );
+		h5::write(ds, ptr, h5::count{10} );
+	}
+	auto open_datasets = [](const h5::fd_t& fd ){
+		return H5Fget_obj_count( static_cast<::hid_t>(fd), H5F_OBJ_DATASET | H5F_OBJ_LOCAL ); };
+	h5::fd_t fd = h5::open("test.h5", H5F_ACC_RDWR);
+	h5::set_ds_cache(fd, 2);
+	// hit: property list made for each call is compared by content
+	for( int i=0; i<3; i++ ){
+		h5::dapl_t dapl = h5::high_throughput;
+		h5::read(fd, path[0], buf.data(), h5::count{10}, dapl );
+		ASSERT_EQ( buf[9], 1 );
+	}
+	h5::dapl_t dapl = h5::high_throughput;
+	ASSERT_EQ( fd.cache->size(), 1 );
+	ASSERT_EQ( open_datasets(fd), 1 );
+	ASSERT_NE( fd.cache->find(path[0], dapl), nullptr );
+	ASSERT_EQ( fd.cache->find(path[0], h5::prefetch{2}), nullptr );
+	// least recently used is closed past capacity, copies of fd share the cache
+	h5::fd_t copy = fd;
+	h5::write(copy, path[1], ptr, h5::count{10}, dapl );
+	h5::read(fd, path[0], buf.data(), h5::count{10}, dapl );
+	h5::read(copy, path[2], buf.data(), h5::count{10}, dapl );
+	ASSERT_EQ( fd.cache, copy.cache );
+	ASSERT_EQ( fd.cache->size(), 2 );
+	ASSERT_EQ( open_datasets(fd), 2 );
+	ASSERT_EQ( fd.cache->find(path[1], dapl), nullptr );
+	ASSERT_NE( fd.cache->find(path[0], dapl), nullptr );
+	ASSERT_NE( fd.cache->find(path[2], dapl), nullptr );
+	// off: cached datasets are closed
+	h5::set_ds_cache(fd, 0);
+	copy = fd;
+	ASSERT_EQ( copy.cache, nullptr );
+	h5::read(fd, path[1], buf.data(), h5::count{10}, dapl );
+	ASSERT_EQ( open_datasets(fd), 0 );
+}
+
 /*----------- BEGIN TEST RUNNER ---------------*/
 H5CPP_TEST_RUNNER( int argc, char**  argv );
 /*----------------- END -----------------------*/
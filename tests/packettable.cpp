@@ -113,6 +113,240 @@ TYPED_TEST(PacketTableTest,save_into_stream) {
 			h5::append(pt, record);
 }
 
+TYPED_TEST(PacketTableTest, background_flush) {
+	auto stream = h5::utils::get_test_data<TypeParam>(200);
+	{ // chunks are compressed and written on a background thread, at most 2 of them in flight
+		h5::pt_t pt = h5::create<TypeParam>(this->fd, "background flush",
+				h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9}, h5::async_write{2} );
+		for( auto record : stream )
+			h5::append(pt, record);
+	}
+	auto data = h5::read<std::vector<TypeParam>>(this->fd, "background flush");
+	ASSERT_EQ( data.size(), stream.size() );
+	for( size_t i=0; i < stream.size(); i++ )
+		ASSERT_EQ( data[i].field2, stream[i].field2 );
+}
+TYPED_TEST(PacketTableTest, bulk_append) {
+	auto stream = h5::utils::get_test_data<TypeParam>(200);
+	{ // partial chunk is topped up, whole chunks are written from `stream`, the remainder is cached
+		h5::pt_t pt = h5::create<TypeParam>(this->fd, "bulk append",
+				h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} );
+		h5::append(pt, stream[0]);
+		h5::append(pt, stream.data() + 1, 150);
+		h5::append(pt, stream.data() + 151, stream.data() + stream.size());
+	}
+	auto data = h5::read<std::vector<TypeParam>>(this->fd, "bulk append");
+	ASSERT_EQ( data.size(), stream.size() );
+	for( size_t i=0; i < stream.size(); i++ )
+		ASSERT_EQ( data[i].field2, stream[i].field2 );
+}
+TYPED_TEST(PacketTableTest, extent_reserve) {
+	auto stream = h5::utils::get_test_data<TypeParam>(160);
+	auto extent = [&]{ // of dataset on disk
+		h5::ds_t ds = h5::open(this->fd, "extent reserve");
+		h5::sp_t file_space = h5::get_space( ds );
+		return H5Sget_simple_extent_npoints( static_cast<hid_t>( file_space ) );
+	};
+	{ // extent is doubled ahead of appended chunks, and trimmed to the records when flushed
+		h5::pt_t pt = h5::create<TypeParam>(this->fd, "extent reserve",
+				h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} );
+		for( size_t i=0; i < 101; i++ )
+			h5::append(pt, stream[i]);
+		ASSERT_EQ( extent(), 160 ); // 20, 40, 80, 160
+		pt.flush();
+		ASSERT_EQ( extent(), 101 );
+		for( size_t i=101; i < stream.size(); i++ )
+			h5::append(pt, stream[i]);
+		ASSERT_EQ( extent(), 202 );
+	}
+	ASSERT_EQ( extent(), stream.size() );
+	auto data = h5::read<std::vector<TypeParam>>(this->fd, "extent reserve");
+	for( size_t i=0; i < stream.size(); i++ )
+		ASSERT_EQ( data[i].field1, stream[i].field1 );
+}
+TYPED_TEST(PacketTableTest, exact_flush) {
+	auto stream = h5::utils::get_test_data<TypeParam>(200);
+	{ // dataset is set to the records appended so far, partial chunk is kept and rewritten
+		h5::pt_t pt = h5::create<TypeParam>(this->fd, "exact flush",
+				h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} );
+		h5::append(pt, stream.data(), 45);
+		pt.flush();
+		ASSERT_EQ( h5::read<std::vector<TypeParam>>(this->fd, "exact flush").size(), 45 );
+		h5::append(pt, stream.data() + 45, 50);
+	}
+	{ // trailing partial chunk is filled up when reopened
+		h5::pt_t pt = h5::open(this->fd, "exact flush");
+		h5::append(pt, stream.data() + 95, stream.data() + stream.size());
+	}
+	auto data = h5::read<std::vector<TypeParam>>(this->fd, "exact flush");
+	ASSERT_EQ( data.size(), stream.size() );
+	for( size_t i=0; i < stream.size(); i++ )
+		ASSERT_EQ( data[i].field2, stream[i].field2 );
+}
+TYPED_TEST(PacketTableTest, multi_producer) {
+	auto stream = h5::utils::get_test_data<TypeParam>(200);
+	{ // producers reserve slots with an atomic cursor, records of each of them are kept in order
+		h5::mpt_t pt = h5::create<TypeParam>(this->fd, "multi producer",
+				h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} );
+		std::vector<std::thread> producers;
+		for( int k=0; k<4; k++ )
+			producers.emplace_back([&,k]{
+				for( size_t i=k; i < stream.size(); i+=4 )
+					h5::append(pt, stream[i]);
+			});
+		for( auto& producer : producers )
+			producer.join();
+	}
+	auto data = h5::read<std::vector<TypeParam>>(this->fd, "multi producer");
+	ASSERT_EQ( data.size(), stream.size() );
+	std::vector<size_t> next{0,1,2,3};
+	for( auto& record : data ){
+		size_t i = record.field1;
+		ASSERT_EQ( i, next[i % 4] );
+		next[i % 4] += 4;
+	}
+}
+TYPED_TEST(PacketTableTest, streaming_read) {
+	auto stream = h5::utils::get_test_data<TypeParam>(210);
+	{
+		h5::pt_t pt = h5::create<TypeParam>(this->fd, "streaming read",
+				h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} );
+		h5::append(pt, stream.data(), stream.size());
+	}
+	// chunk at a time into the same buffer, the next two decoded in the background
+	h5::pt_reader<TypeParam> reader = h5::open(this->fd, "streaming read", h5::prefetch{2});
+	ASSERT_EQ( reader.records(), stream.size() );
+	size_t i = 0;
+	for( const auto& record : reader )
+		ASSERT_EQ( record.field2, stream[i++].field2 );
+	ASSERT_EQ( i, stream.size() );
+}
+TYPED_TEST(PacketTableTest, columnar) {
+	auto stream = h5::utils::get_test_data<TypeParam>(210);
+	{ // a dataset for each field within group
+		h5::cpt_t<TypeParam> pt(this->fd, "columnar", h5::chunk{20} | h5::gzip{9} );
+		h5::append(pt, stream.data(), 100);
+		for( size_t i=100; i < stream.size(); i++ )
+			h5::append(pt, stream[i]);
+	}
+	// only the requested fields are read, the rest of them are zero
+	h5::cpt_reader<TypeParam> reader(this->fd, "columnar", {"field1"});
+	size_t i = 0;
+	for( const auto& record : reader ){
+		ASSERT_EQ( record.field1, stream[i++].field1 );
+		ASSERT_EQ( record.field2, 0.0 );
+	}
+	ASSERT_EQ( i, stream.size() );
+}
+TYPED_TEST(PacketTableTest, key_index_range) {
+	auto stream = h5::utils::get_test_data<TypeParam>(210);
+	{ // records are in `field1` order, key range of each chunk is kept in "key index.index"
+		h5::pt_t pt = h5::create<TypeParam>(this->fd, "key index",
+				h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} );
+		h5::key_index(pt, &TypeParam::field1);
+		h5::append(pt, stream.data(), 105);
+		pt.flush();
+		for( size_t i=105; i < stream.size(); i++ )
+			h5::append(pt, stream[i]);
+	}
+	auto data = h5::read_range(this->fd, "key index", &TypeParam::field1, 37u, 143u);
+	ASSERT_EQ( data.size(), 143 - 37 );
+	for( size_t i=0; i < data.size(); i++ )
+		ASSERT_EQ( data[i].field1, stream[37 + i].field1 );
+	ASSERT_TRUE( h5::read_range(this->fd, "key index", &TypeParam::field1, 500u, 600u).empty() );
+}
+TYPED_TEST(PacketTableTest, key_index_int64) {
+	// keys past 2^53 are apart by less than the precision of a double
+	const int64_t base = int64_t(1) << 60;
+	std::vector<sn::stamped_t> stream(100);
+	for( size_t i=0; i < stream.size(); i++ )
+		stream[i] = sn::stamped_t{ base + int64_t(i), double(i) };
+	{
+		h5::pt_t pt = h5::create<sn::stamped_t>(this->fd, "key index int64", h5::max_dims{H5S_UNLIMITED}, h5::chunk{10} );
+		h5::key_index(pt, &sn::stamped_t::stamp);
+		h5::append(pt, stream.data(), stream.size());
+	}
+	auto data = h5::read_range(this->fd, "key index int64", &sn::stamped_t::stamp, base + 35, base + 47);
+	ASSERT_EQ( data.size(), 12 );
+	for( size_t i=0; i < data.size(); i++ )
+		ASSERT_EQ( data[i].stamp, base + 35 + int64_t(i) );
+	ASSERT_EQ( h5::read_range(this->fd, "key index int64", &sn::stamped_t::stamp, base + 99, base + 100).size(), 1 );
+}
+TYPED_TEST(PacketTableTest, shared_budget) {
+	auto stream = h5::utils::get_test_data<TypeParam>(210);
+	{ // room for scratch and 3 chunk caches: tables appended round robin are flushed and reloaded
+		std::deque<h5::pt_t> pt;
+		for( int i=0; i<8; i++ )
+			pt.emplace_back( h5::create<TypeParam>(this->fd, "shared budget/" + std::to_string(i),
+					h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} ) );
+		h5::pt_manager_t manager( 5 * pt[0].pipeline.buffer_size );
+		for( auto& table : pt )
+			manager.attach( table );
+		for( size_t i=0; i < stream.size(); i++ )
+			for( auto& table : pt ){
+				h5::append(table, stream[i]);
+				ASSERT_LE( manager.size(), manager.budget );
+			}
+		ASSERT_GT( manager.evictions(), 0 );
+	}
+	for( int i=0; i<8; i++ ){
+		auto data = h5::read<std::vector<TypeParam>>(this->fd, "shared budget/" + std::to_string(i));
+		ASSERT_EQ( data.size(), stream.size() );
+		for( size_t j=0; j < stream.size(); j++ )
+			ASSERT_EQ( data[j].field1, stream[j].field1 );
+	}
+}
+TYPED_TEST(PacketTableTest, swmr_tail) {
+	auto stream = h5::utils::get_test_data<TypeParam>(210);
+	h5::create<TypeParam>(this->fd, "swmr tail", h5::max_dims{H5S_UNLIMITED}, h5::chunk{20} | h5::gzip{9} );
+	// flushed every 25 records at the latest: extent is exact, partial chunks are read again once grown
+	h5::pt_t pt = h5::open(this->fd, "swmr tail", h5::swmr_flush({25, 0}) );
+	h5::pt_tail<TypeParam> tail = h5::open(this->fd, "swmr tail");
+	std::vector<TypeParam> data;
+	for( size_t i=0; i < stream.size(); i++ ){
+		h5::append(pt, stream[i]);
+		tail.poll( data );
+		ASSERT_GE( data.size(), (i + 1) / 25 * 25 );
+		ASSERT_LE( data.size(), i + 1 );
+	}
+	pt.flush();
+	tail.poll( data );
+	ASSERT_EQ( data.size(), stream.size() );
+	for( size_t i=0; i < stream.size(); i++ )
+		ASSERT_EQ( data[i].field1, stream[i].field1 );
+	try { // reason of failure reaches the caller
+		h5::pt_t async = h5::open(this->fd, "swmr tail", h5::swmr_flush({25, 0}) | h5::async_write{2} );
+		ADD_FAILURE();
+	} catch ( const h5::error::io::packet_table::misc& err ){
+		ASSERT_NE( std::string( err.what() ).find("SWMR"), std::string::npos );
+	}
+}
+
+TYPED_TEST(PacketTableTest, cached_type) {
+	::hid_t id;
+	{ // descriptors of a registered type share the id built once, each holding a reference of its own
+		h5::dt_t<TypeParam> a, b;
+		id = static_cast<::hid_t>( a );
+		ASSERT_EQ( id, static_cast<::hid_t>( b ) );
+		ASSERT_EQ( H5Tget_class( id ), H5T_COMPOUND );
+		ASSERT_EQ( H5Iget_ref( id ), 3 );
+	}
+	ASSERT_GT( H5Iis_valid( id ), 0 ); // kept by the cache
+	ASSERT_EQ( H5Iget_ref( id ), 1 );
+	h5::dt_t<TypeParam> c;
+	ASSERT_EQ( id, static_cast<::hid_t>( c ) );
+
+	auto stream = h5::utils::get_test_data<TypeParam>(50);
+	h5::write(this->fd, "cached type", stream);
+	auto data = h5::read<std::vector<TypeParam>>(this->fd, "cached type");
+	ASSERT_EQ( data.size(), stream.size() );
+	for( size_t i=0; i < stream.size(); i++ ){
+		ASSERT_EQ( data[i].field1, stream[i].field1 );
+		ASSERT_EQ( data[i].field2, stream[i].field2 );
+		ASSERT_EQ( data[i].field9, stream[i].field9 );
+	}
+	ASSERT_EQ( H5Iget_ref( id ), 2 ); // IO calls release the references they take
+}
 
 /*----------- BEGIN TEST RUNNER ---------------*/
 H5CPP_TEST_RUNNER( int argc, char**  argv );
@@ -76,6 +76,238 @@ TYPED_TEST(ArmadilloTest, BlockReadArmadillo) {
 	//h5::read(this->fd,this->name+".mat", m.memptr(), h5::count{2,2}, h5::block{2,2} );
 }
 
+TYPED_TEST(ArmadilloTest, ThreadedPipelineWrite) {
+
+	arma::Mat<TypeParam>  M(64,64);    for(int i=0; i < M.size(); i++ ) M[i] = i;
+	{ // chunks are compressed on worker threads then written in order
+		h5::ds_t ds = h5::create<TypeParam>(this->fd, this->name+".mt",
+				h5::current_dims{64,64}, h5::chunk{4,64} | h5::gzip{6}, h5::num_threads{4});
+		h5::write(ds, M);
+	}
+	// read back through HDF5 CAPI filter pipeline
+	auto m = h5::read<arma::Mat<TypeParam>>(this->fd, this->name+".mt");
+	ASSERT_TRUE( arma::all( arma::vectorise(m == M) ) );
+}
+
+TYPED_TEST(ArmadilloTest, AsyncPipelineWrite) {
+
+	arma::Mat<TypeParam>  M(64,64);    for(int i=0; i < M.size(); i++ ) M[i] = i;
+	{ // chunks are compressed in this thread while the previous ones are written in the background
+		h5::ds_t ds = h5::create<TypeParam>(this->fd, this->name+".async",
+				h5::current_dims{64,64}, h5::chunk{4,64} | h5::gzip{6}, h5::async_write{3});
+		h5::write(ds, M);
+	}
+	auto m = h5::read<arma::Mat<TypeParam>>(this->fd, this->name+".async");
+	ASSERT_TRUE( arma::all( arma::vectorise(m == M) ) );
+}
+
+TYPED_TEST(ArmadilloTest, ShuffleGzipRead) {
+
+	arma::Mat<TypeParam>  M(64,64);    for(int i=0; i < M.size(); i++ ) M[i] = i;
+	// written by HDF5 CAPI filter pipeline, read back with reverse filter chain of h5cpp
+	h5::write(this->fd, this->name+".sg", M, h5::chunk{4,64} | h5::shuffle | h5::gzip{6} | h5::fletcher32);
+	auto m = h5::read<arma::Mat<TypeParam>>(this->fd, this->name+".sg", h5::high_throughput);
+	ASSERT_TRUE( arma::all( arma::vectorise(m == M) ) );
+}
+
+TYPED_TEST(ArmadilloTest, UnalignedWrite) {
+
+	arma::Mat<TypeParam>  M(12,12);    M.ones();
+	arma::Mat<TypeParam>  T(5,5);      T.zeros();
+	h5::ds_t ds = h5::create<TypeParam>(this->fd, this->name+".rmw",
+			h5::current_dims{12,12}, h5::chunk{4,4} | h5::gzip{6}, h5::high_throughput);
+	h5::write(ds, M);
+	// tile partially covers 9 chunks, the rest of them must be preserved
+	h5::write(ds, T, h5::offset{3,5});
+	auto m = h5::read<arma::Mat<TypeParam>>(this->fd, this->name+".rmw");
+	ASSERT_EQ( arma::accu(m), 12*12 - 5*5 );
+}
+
+TYPED_TEST(ArmadilloTest, StridedRead) {
+
+	arma::Mat<TypeParam>  M(24,24);    for(int i=0; i < M.size(); i++ ) M[i] = i;
+	arma::Mat<TypeParam>  a(6,12), b(6,12);
+	h5::write(this->fd, this->name+".dec", M, h5::chunk{4,4} | h5::gzip{6});
+	// decimated blocks, same selection through HDF5 CAPI and h5cpp pipeline
+	h5::read(this->fd, this->name+".dec", a.memptr(), h5::offset{1,0}, h5::stride{4,2}, h5::block{2,1}, h5::count{6,6});
+	h5::read(this->fd, this->name+".dec", b.memptr(), h5::offset{1,0}, h5::stride{4,2}, h5::block{2,1}, h5::count{6,6},
+			h5::high_throughput);
+	ASSERT_TRUE( arma::all( arma::vectorise(a == b) ) );
+}
+
+TYPED_TEST(ArmadilloTest, PrefetchRead) {
+
+	arma::Mat<TypeParam>  M(64,64);    for(int i=0; i < M.size(); i++ ) M[i] = i;
+	arma::Mat<TypeParam>  m(64,64);
+	h5::write(this->fd, this->name+".pf", M, h5::chunk{4,64} | h5::gzip{6});
+	h5::ds_t ds = h5::open(this->fd, this->name+".pf", h5::prefetch{4});
+	// column frames in chunk order: after the first few reads chunks are decoded ahead of the scan
+	for(int j=0; j<64; j+=2 )
+		h5::read(ds, m.colptr(j), h5::count{2,64}, h5::offset{j,0});
+	ASSERT_TRUE( arma::all( arma::vectorise(m == M) ) );
+	ASSERT_GT( h5::pipeline_stats(ds).prefetch_hits, 0 );
+}
+
+TYPED_TEST(ArmadilloTest, DecodedCacheRead) {
+
+	arma::Mat<TypeParam>  M(64,64);    for(int i=0; i < M.size(); i++ ) M[i] = i;
+	arma::Mat<TypeParam>  m(8,8);
+	h5::write(this->fd, this->name+".lru", M, h5::chunk{16,16} | h5::gzip{6});
+	h5::ds_t ds = h5::open(this->fd, this->name+".lru", h5::decoded_cache{1<<20});
+	// overlapping windows: each chunk is decoded once
+	for(int j=0; j<32; j+=4 )
+		h5::read(ds, m.memptr(), h5::count{8,8}, h5::offset{j,j});
+	ASSERT_TRUE( arma::all( arma::vectorise(m == M.submat(28,28,35,35)) ) );
+	h5::pipeline_stats_t stats = h5::pipeline_stats(ds);
+	ASSERT_EQ( stats.cache_misses, 7 );
+	ASSERT_EQ( stats.cache_evictions, 0 );
+}
+
+namespace shuffle_ = h5::impl::filter::shuffle_;
+// vectorized kernels against the scalar reference: element sizes with and without kernels, lengths with tails
+TEST(ShuffleTest, DispatchMatchesScalar) {
+	for( size_t M : {1,2,3,4,5,7,8,12,16} )
+		for( size_t N : {1,7,15,16,17,31,32,33,47,100,1031} ){
+			std::vector<unsigned char> in(N*M), expected(N*M), out(N*M), back(N*M);
+			for( auto& b : in ) b = std::rand();
+			shuffle_::shuffle_scalar( expected.data(), in.data(), N, M, 0 );
+			shuffle_::shuffle( out.data(), in.data(), N, M );
+			ASSERT_EQ( out, expected ) << "shuffle M=" << M << " N=" << N;
+			shuffle_::unshuffle( back.data(), expected.data(), N, M );
+			ASSERT_EQ( back, in ) << "unshuffle M=" << M << " N=" << N;
+		}
+}
+#ifdef H5CPP_HAVE_X86_SIMD
+// each kernel stops at the last whole block, the rest is left to the scalar tail
+template <size_t M> void shuffle_kernels( size_t N ){
+	std::vector<unsigned char> in(N*M), expected(N*M), out(N*M), back(N*M);
+	for( auto& b : in ) b = std::rand();
+	shuffle_::shuffle_scalar( expected.data(), in.data(), N, M, 0 );
+
+	shuffle_::shuffle_scalar( out.data(), in.data(), N, M, shuffle_::shuffle_sse2<M>( out.data(), in.data(), N, 0 ) );
+	ASSERT_EQ( out, expected ) << "sse2 shuffle M=" << M << " N=" << N;
+	shuffle_::unshuffle_scalar( back.data(), expected.data(), N, M,
+			shuffle_::unshuffle_sse2<M>( back.data(), expected.data(), N, 0 ) );
+	ASSERT_EQ( back, in ) << "sse2 unshuffle M=" << M << " N=" << N;
+	if( !shuffle_::has_avx2() ) return;
+	std::fill( out.begin(), out.end(), 0 ); std::fill( back.begin(), back.end(), 0 );
+	shuffle_::shuffle_scalar( out.data(), in.data(), N, M, shuffle_::shuffle_avx2<M>( out.data(), in.data(), N, 0 ) );
+	ASSERT_EQ( out, expected ) << "avx2 shuffle M=" << M << " N=" << N;
+	shuffle_::unshuffle_scalar( back.data(), expected.data(), N, M,
+			shuffle_::unshuffle_avx2<M>( back.data(), expected.data(), N, 0 ) );
+	ASSERT_EQ( back, in ) << "avx2 unshuffle M=" << M << " N=" << N;
+}
+TEST(ShuffleTest, KernelsMatchScalar) {
+	for( size_t N : {1,15,16,17,31,32,33,63,64,65,1031} ){
+		shuffle_kernels<2>( N ); shuffle_kernels<4>( N ); shuffle_kernels<8>( N ); shuffle_kernels<16>( N );
+	}
+}
+#endif
+
+/* frame of `count` at `offset` written and read back through h5cpp pipeline into a dataset filled by HDF5 CAPI,
+ * then the entire dataset read by HDF5 CAPI is checked against the expected content */
+template <class T>
+void frame_round_trip( const h5::fd_t& fd, const std::string& path, const h5::current_dims_t& dims, const h5::dcpl_t& dcpl,
+		const h5::offset_t& offset, const h5::count_t& count ){
+	size_t size = 1, n = 1;
+	h5::count_t all; all.rank = dims.rank;
+	for( int i=0; i<dims.rank; i++ ) size *= all[i] = dims[i], n *= count[i];
+	std::vector<T> expected( size ), frame( n ), back( n );
+	for( size_t k=0; k<size; k++ ) expected[k] = k % 101;
+	for( size_t k=0; k<n; k++ ) frame[k] = 200 + k % 101;
+	{
+		h5::ds_t ds = h5::create<T>(fd, path, dims, dcpl);
+		h5::write(ds, static_cast<const T*>( expected.data() ), all);
+	}
+	h5::ds_t ds = h5::open(fd, path, h5::high_throughput);
+	h5::write(ds, static_cast<const T*>( frame.data() ), offset, count);
+	h5::read(ds, back.data(), offset, count);
+	ASSERT_EQ( back, frame ) << path;
+
+	for( size_t k=0; k<size; k++ ){ // paste frame into expected content
+		size_t rest = k, at = 0; bool inside = true;
+		for( int i=dims.rank-1, stride=1; i>=0; stride *= count[i], i-- ){
+			hsize_t x = rest % dims[i]; rest /= dims[i];
+			inside &= x >= offset[i] && x < offset[i] + count[i];
+			at += (x - offset[i]) * stride;
+		}
+		if( inside ) expected[k] = frame[at];
+	}
+	ASSERT_EQ( h5::read<std::vector<T>>(fd, path), expected ) << path;
+}
+
+TYPED_TEST(ArmadilloTest, FrameRoundTrip) {
+	// rank 1: chunk aligned frame is decoded into user memory, unaligned one is staged
+	frame_round_trip<TypeParam>(this->fd, this->name+".1 aligned", h5::current_dims{96}, h5::chunk{8} | h5::gzip{1},
+			h5::offset{16}, h5::count{32});
+	frame_round_trip<TypeParam>(this->fd, this->name+".1 unaligned", h5::current_dims{96}, h5::chunk{8} | h5::gzip{1},
+			h5::offset{5}, h5::count{37});
+	// rank 3 and 4: whole chunks are contiguous when trailing chunk extents match the frame
+	frame_round_trip<TypeParam>(this->fd, this->name+".3 aligned", h5::current_dims{12,6,7}, h5::chunk{2,6,7} | h5::gzip{1},
+			h5::offset{2,0,0}, h5::count{6,6,7});
+	frame_round_trip<TypeParam>(this->fd, this->name+".3 unaligned", h5::current_dims{12,6,8}, h5::chunk{2,3,4} | h5::gzip{1},
+			h5::offset{1,1,2}, h5::count{5,4,3});
+	frame_round_trip<TypeParam>(this->fd, this->name+".4 aligned", h5::current_dims{6,5,4,3}, h5::chunk{1,5,4,3} | h5::gzip{1},
+			h5::offset{2,0,0,0}, h5::count{3,5,4,3});
+	frame_round_trip<TypeParam>(this->fd, this->name+".4 unaligned", h5::current_dims{6,6,6,4}, h5::chunk{2,2,3,2} | h5::gzip{1},
+			h5::offset{1,1,0,1}, h5::count{4,3,4,2});
+}
+
+TYPED_TEST(ArmadilloTest, FrameRoundTripEdgeChunks) {
+	// dataset extent is not a multiple of chunk size: edge chunks are covered only within the extent
+	frame_round_trip<TypeParam>(this->fd, this->name+".1 edge", h5::current_dims{100}, h5::chunk{8} | h5::gzip{1},
+			h5::offset{88}, h5::count{12});
+	frame_round_trip<TypeParam>(this->fd, this->name+".3 edge", h5::current_dims{11,6,7}, h5::chunk{2,6,7} | h5::gzip{1},
+			h5::offset{0,0,0}, h5::count{11,6,7});
+	frame_round_trip<TypeParam>(this->fd, this->name+".4 edge", h5::current_dims{5,5,5,5}, h5::chunk{2,2,2,2} | h5::gzip{1},
+			h5::offset{1,0,1,0}, h5::count{4,5,4,5});
+}
+
+/* blocks at `offset` apart by `stride` written through h5cpp pipeline into a dataset filled by HDF5 CAPI,
+ * the same selection is written by HDF5 CAPI into a reference dataset, then both are read back by HDF5 CAPI */
+template <class T>
+void strided_round_trip( const h5::fd_t& fd, const std::string& path, const h5::current_dims_t& dims, const h5::dcpl_t& dcpl,
+		const h5::offset_t& offset, const h5::stride_t& stride, const h5::block_t& block, const h5::count_t& count ){
+	size_t size = 1, n = 1;
+	h5::count_t all; all.rank = dims.rank;
+	for( int i=0; i<dims.rank; i++ ) size *= all[i] = dims[i], n *= count[i] * block[i];
+	std::vector<T> background( size ), blocks( n ), expected( size ), back( size );
+	for( size_t k=0; k<size; k++ ) background[k] = k % 101;
+	for( size_t k=0; k<n; k++ ) blocks[k] = 200 + k % 101;
+	for( const std::string& name : {path, path + ".capi"} ){
+		h5::ds_t ds = h5::create<T>(fd, name, dims, dcpl);
+		h5::write(ds, static_cast<const T*>( background.data() ), all);
+	}
+	{
+		h5::ds_t ds = h5::open(fd, path, h5::high_throughput);
+		h5::write(ds, static_cast<const T*>( blocks.data() ), offset, stride, block, count);
+	}
+	h5::ds_t ref = h5::open(fd, path + ".capi"), ds = h5::open(fd, path);
+	h5::dt_t<T> type;
+	hsize_t mem_dims[H5CPP_MAX_RANK];
+	for( int i=0; i<dims.rank; i++ ) mem_dims[i] = count[i] * block[i];
+	h5::sp_t mem_space{H5Screate_simple( dims.rank, mem_dims, nullptr )}, file_space = h5::get_space( ref );
+	H5Sselect_hyperslab( static_cast<::hid_t>( file_space ), H5S_SELECT_SET, *offset, *stride, *count, *block );
+	ASSERT_GE( H5Dwrite( static_cast<::hid_t>( ref ), static_cast<::hid_t>( type ), static_cast<::hid_t>( mem_space ),
+		static_cast<::hid_t>( file_space ), H5P_DEFAULT, blocks.data() ), 0 ) << path;
+	ASSERT_GE( H5Dread( static_cast<::hid_t>( ref ), static_cast<::hid_t>( type ), H5S_ALL, H5S_ALL,
+		H5P_DEFAULT, expected.data() ), 0 ) << path;
+	ASSERT_GE( H5Dread( static_cast<::hid_t>( ds ), static_cast<::hid_t>( type ), H5S_ALL, H5S_ALL,
+		H5P_DEFAULT, back.data() ), 0 ) << path;
+	ASSERT_NE( expected, background ) << path;
+	ASSERT_EQ( back, expected ) << path;
+}
+
+TYPED_TEST(ArmadilloTest, StridedWrite) {
+	// extent is not a multiple of chunk size: selected blocks reach into the partial edge chunks
+	strided_round_trip<TypeParam>(this->fd, this->name+".1 strided", h5::current_dims{101}, h5::chunk{8} | h5::gzip{1},
+			h5::offset{3}, h5::stride{7}, h5::block{3}, h5::count{14});
+	strided_round_trip<TypeParam>(this->fd, this->name+".2 strided", h5::current_dims{23,19}, h5::chunk{4,5} | h5::gzip{1},
+			h5::offset{1,2}, h5::stride{5,4}, h5::block{2,3}, h5::count{5,4});
+	strided_round_trip<TypeParam>(this->fd, this->name+".3 strided", h5::current_dims{11,9,7}, h5::chunk{2,4,3} | h5::gzip{1},
+			h5::offset{0,1,1}, h5::stride{3,2,2}, h5::block{1,1,2}, h5::count{4,4,3});
+}
+
 /*----------- BEGIN TEST RUNNER ---------------*/
 H5CPP_TEST_RUNNER( int argc, char**  argv );
 /*----------------- END -----------------------*/
@@ -72,6 +72,90 @@ TYPED_TEST(STLTest, stl_multidim_gzip) {
 }
 */
 
+template <typename T> class StringTest : public AbstractTest<T>{};
+TYPED_TEST_CASE(StringTest, ::testing::Types<std::string>);
+TYPED_TEST(StringTest, arena_read) {
+	std::vector<std::string> vec(20);
+	for( size_t i=0; i<vec.size(); i++ )
+		if( i % 3 ) vec[i] = std::string(i, 'a' + i);
+	h5::write(this->fd, this->name, vec );
+	h5::ds_t ds = h5::open(this->fd, this->name);
+
+	h5::arena_t arena(64); // spans several blocks
+	std::vector<std::string_view> first = h5::read(ds, arena, h5::count{5}, h5::offset{7} );
+	ASSERT_EQ( first.size(), 5 );
+	for( size_t i=0; i<first.size(); i++ ) ASSERT_EQ( first[i], vec[7 + i] );
+	// views of earlier reads stay valid until clear()
+	std::vector<std::string_view> second = h5::read(this->fd, this->name, arena );
+	ASSERT_EQ( second.size(), vec.size() );
+	for( size_t i=0; i<vec.size(); i++ ) ASSERT_EQ( second[i], vec[i] );
+	for( size_t i=0; i<first.size(); i++ ) ASSERT_EQ( first[i], vec[7 + i] );
+	ASSERT_TRUE( first[2].empty() ); // vec[9]
+
+	size_t capacity = arena.capacity();
+	for( int k=0; k<3; k++ ){ // warm arena is reused
+		arena.clear();
+		ASSERT_EQ( arena.size(), 0 );
+		std::vector<std::string_view> again = h5::read(ds, arena, h5::count{10}, h5::offset{10} );
+		for( size_t i=0; i<again.size(); i++ ) ASSERT_EQ( again[i], vec[10 + i] );
+		ASSERT_EQ( arena.capacity(), capacity );
+	}
+}
+
+TYPED_TEST(StringTest, fixed_length) {
+	std::vector<std::string> vec{"alpha", "", "gamma", "epsilon", "pi"};
+	h5::write(this->fd, this->name + " longest", vec, h5::fixed_length{0} );
+	h5::write(this->fd, this->name + " 8", vec, h5::fixed_length{8}, h5::max_dims{H5S_UNLIMITED} );
+	ASSERT_EQ( h5::read<std::vector<std::string>>(this->fd, this->name + " longest"), vec );
+	ASSERT_EQ( h5::read<std::vector<std::string>>(this->fd, this->name + " 8"), vec );
+	{
+		h5::ds_t ds = h5::open(this->fd, this->name + " longest");
+		h5::dt_t<void*> type{ H5Dget_type( static_cast<::hid_t>(ds) ) };
+		ASSERT_EQ( H5Tget_size( static_cast<::hid_t>(type) ), 7 );
+	}
+	h5::ds_t ds = h5::open(this->fd, this->name + " 8");
+	std::vector<std::string> fits{"12345678"}, longer{"123456789"};
+	h5::write(ds, fits, h5::offset{1} );
+	EXPECT_THROW( h5::write(ds, longer, h5::offset{2} ), h5::error::io::dataset::write );
+	vec[1] = fits[0];
+	ASSERT_EQ( h5::read<std::vector<std::string>>(ds), vec );
+}
+
+TYPED_TEST(StringTest, dictionary) {
+	std::vector<std::string> first{"AAPL", "MSFT", "AAPL", "", "IBM"}, second{"IBM", "ORCL", "AAPL", "", "ORCL"};
+	std::vector<std::string> all( first );
+	all.insert( all.end(), second.begin(), second.end() );
+	std::string path = this->name + " symbols";
+	h5::write(this->fd, path, first, h5::dictionary, h5::max_dims{H5S_UNLIMITED} );
+	h5::ds_t a = h5::open(this->fd, path), b = h5::open(this->fd, path);
+	ASSERT_EQ( h5::read<std::vector<std::string>>(b), first ); // dictionary of `b` loaded
+	// second call at an offset reuses codes, new entries seen through the other descriptor
+	h5::set_extent(a, h5::current_dims{10} );
+	h5::write(a, second, h5::offset{5} );
+	ASSERT_EQ( h5::read<std::vector<std::string>>(b), all );
+	h5::arena_t arena;
+	std::vector<std::string_view> views = h5::read(this->fd, path, arena, h5::count{4}, h5::offset{5} );
+	for( size_t i=0; i<views.size(); i++ ) ASSERT_EQ( views[i], second[i] );
+	std::vector<unsigned> codes = h5::read<std::vector<unsigned>>(this->fd, path );
+	ASSERT_EQ( codes[0], codes[2] ); ASSERT_EQ( codes[0], codes[7] ); ASSERT_EQ( codes[4], codes[5] );
+	ASSERT_EQ( codes[6], codes[9] );
+	h5::ds_t words = h5::open(this->fd, path + ".dictionary");
+	ASSERT_EQ( H5Sget_simple_extent_npoints( static_cast<::hid_t>( h5::get_space(words) ) ), 5 );
+	// codes without dictionary don't hold strings
+	h5::write(this->fd, this->name + " codes", codes );
+	EXPECT_THROW( h5::read<std::vector<std::string>>(this->fd, this->name + " codes"), h5::error::io::dataset::read );
+}
+
+TYPED_TEST(StringTest, dictionary_in_group) {
+	std::vector<std::string> vec{"bid", "ask", "ask", "trade", "bid"};
+	std::string path = this->name + "/market/side";
+	h5::write(this->fd, path, vec, h5::dictionary, h5::chunk{2} | h5::gzip{1}, h5::max_dims{H5S_UNLIMITED} );
+	ASSERT_EQ( h5::read<std::vector<std::string>>(this->fd, path), vec );
+	h5::ds_t ds = h5::open(this->fd, path);
+	ASSERT_EQ( h5::impl::get_dictionary_path( static_cast<::hid_t>(ds) ), "/" + path + ".dictionary" );
+	ASSERT_GT( H5Lexists( static_cast<::hid_t>(this->fd), (path + ".dictionary").data(), H5P_DEFAULT ), 0 );
+}
+
 /*----------- BEGIN TEST RUNNER ---------------*/
 H5CPP_TEST_RUNNER( int argc, char**  argv );
 /*----------------- END -----------------------*/
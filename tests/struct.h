@@ -34,6 +34,22 @@ namespace h5{
 }
 H5CPP_REGISTER_STRUCT(sn::struct_type );
 
+namespace SomeNameSpace {
+	struct stamped_t { // keyed by nanosecond time stamp
+		int64_t stamp;
+		double value;
+	};
+}
+namespace h5{
+    template<> hid_t inline register_struct<sn::stamped_t>(){
+		hid_t type = H5Tcreate(H5T_COMPOUND, sizeof (sn::stamped_t));
+		H5Tinsert(type, "stamp", 	HOFFSET(sn::stamped_t, stamp), H5T_NATIVE_INT64);
+		H5Tinsert(type, "value", 	HOFFSET(sn::stamped_t, value), H5T_NATIVE_DOUBLE);
+		return type;
+	};
+}
+H5CPP_REGISTER_STRUCT(sn::stamped_t );
+
 
 namespace h5 { namespace utils { // this specializations not necessary, only used in tests 
 	template <> std::vector<sn::StructType> get_test_data( size_t n ){